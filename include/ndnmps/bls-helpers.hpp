@@ -119,6 +119,31 @@ ndnBLSAggregateSignature(const std::vector<Buffer>& signatures);
 BLSSignature
 ndnBLSAggregateSignature(const std::vector<BLSSignature>& signatures);
 
+/**
+ * Find the invalid signature shares of the same data packet.
+ * All shares are checked in one randomized batch: each share and its public key are multiplied by
+ * a random 64-bit scalar so that invalid shares cannot cancel out, and the packet is hashed to the curve once.
+ * A failed batch is bisected to isolate the invalid shares.
+ * @param pubKeys the public keys of the shares, in the same order as @p shares
+ * @param data the data packet with signature info
+ * @return the indexes of the invalid shares, empty if all shares are valid
+ */
+std::vector<size_t>
+ndnBLSFindInvalidShares(const std::vector<BLSPublicKey>& pubKeys, const std::vector<BLSSignature>& shares,
+                        const Data& data);
+
+/**
+ * Find the invalid signatures of different data packets.
+ * All packets are checked in one randomized multi-pairing: each signature and public key is multiplied by
+ * a random 64-bit scalar, the Miller loops of all packets share one final exponentiation, and the signatures
+ * are summed into a single pairing. A failed batch is bisected to isolate the invalid packets.
+ * @param pubKeys the (aggregate) public keys of the packets, in the same order as @p data
+ * @param data the signed data packets
+ * @return the indexes of the invalid packets, empty if all packets are valid
+ */
+std::vector<size_t>
+ndnBLSFindInvalidSignatures(const std::vector<BLSPublicKey>& pubKeys, const std::vector<Data>& data);
+
 } // mps
 } // ndn
 
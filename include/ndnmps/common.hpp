@@ -39,7 +39,16 @@ enum : uint32_t {
   ParameterDataName = 205,
   ResultAfter = 209,
   ResultName = 211,
-  BLSSigValue = 213
+  BLSSigValue = 213,
+  SessionId = 215,
+  SessionLifetime = 217,
+  InlineParameter = 219,
+  RetryAfter = 221,
+  SignerKeyName = 223,
+  GroupContentKey = 225,
+  GroupParameterName = 227,
+  ParameterBatch = 229,
+  ServiceTime = 231
 };
 
 /** @brief Extended SignatureType values with Multi-Party Signature
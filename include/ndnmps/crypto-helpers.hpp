@@ -23,6 +23,10 @@
 
 #include "common.hpp"
 #include <openssl/evp.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 namespace ndn {
 namespace mps {
@@ -36,6 +40,15 @@ class ECDHState : noncopyable
 {
 public:
   ECDHState();
+
+  /**
+   * @brief Construct the state from a pre-generated key pair.
+   *
+   * @param privkey The prime256v1 key pair. The state takes the ownership.
+   */
+  explicit
+  ECDHState(EVP_PKEY* privkey);
+
   ~ECDHState();
 
   /**
@@ -63,6 +76,67 @@ private:
   std::vector<uint8_t> m_secret;
 };
 
+/**
+ * @brief A pool of pre-generated prime256v1 key pairs for ECDH.
+ *
+ * A background thread refills the pool to its capacity whenever the number of ready
+ * key pairs drops below the low-water mark, so that key generation is kept out of
+ * packet processing. The curve parameters are generated once and cached.
+ *
+ * The thread is started by the first acquire(), so a pool that is never used costs
+ * nothing. A pool with zero capacity never starts it and generates every key pair
+ * on demand.
+ */
+class ECDHKeyPool : noncopyable
+{
+public:
+  explicit
+  ECDHKeyPool(size_t capacity = 64, size_t lowWaterMark = 16);
+
+  ~ECDHKeyPool();
+
+  /**
+   * @brief Get the pool shared by all signers and initiators of this process.
+   */
+  static std::shared_ptr<ECDHKeyPool>
+  getShared();
+
+  /**
+   * @brief Take a ready key pair from the pool.
+   *
+   * When the pool is drained or disabled, the key pair is generated synchronously.
+   * @return ECDH state owning the key pair.
+   */
+  std::unique_ptr<ECDHState>
+  acquire();
+
+  /**
+   * @brief Set the number of ready key pairs below which the background refill starts.
+   */
+  void
+  setLowWaterMark(size_t lowWaterMark);
+
+  /**
+   * @return The number of ready key pairs in the pool.
+   */
+  size_t
+  size() const;
+
+private:
+  void
+  refill();
+
+private:
+  const size_t m_capacity;
+  size_t m_lowWaterMark;
+  std::deque<EVP_PKEY*> m_keys;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_shouldStop = false;
+  bool m_isStarted = false;
+  std::thread m_worker;
+};
+
 /**
  * @brief HMAC based key derivation function (HKDF).
  *
@@ -97,6 +171,47 @@ hmacSha256(const uint8_t* data, size_t dataLen,
            const uint8_t* key, size_t keyLen,
            uint8_t* result);
 
+/**
+ * @brief Sign the Data with HMAC-SHA256 using a raw key.
+ *
+ * Unlike signing through the KeyChain, the key is not imported into the TPM,
+ * which makes it cheap to use a fresh key for each request.
+ *
+ * @param data The Data to be signed, modified to the signed packet.
+ * @param key The HMAC key.
+ * @param keyLen The length of the HMAC key.
+ * @param keyLocatorName The name placed in the key locator.
+ */
+void
+signDataWithHmac(Data& data, const uint8_t* key, size_t keyLen, const Name& keyLocatorName);
+
+/**
+ * @brief Verify the HMAC-SHA256 signature of the Data with a raw key.
+ *
+ * @return true if the signature type is HMAC-SHA256 and the signature value matches.
+ */
+bool
+verifyDataWithHmac(const Data& data, const uint8_t* key, size_t keyLen);
+
+/**
+ * @brief Sign the Interest (in signed Interest format v0.3) with HMAC-SHA256 using a raw key.
+ *
+ * @param interest The Interest to be signed, modified to the signed packet.
+ * @param key The HMAC key.
+ * @param keyLen The length of the HMAC key.
+ * @param keyLocatorName The name placed in the key locator.
+ */
+void
+signInterestWithHmac(Interest& interest, const uint8_t* key, size_t keyLen, const Name& keyLocatorName);
+
+/**
+ * @brief Verify the HMAC-SHA256 signature of the signed Interest with a raw key.
+ *
+ * @return true if the Interest is signed with HMAC-SHA256 and the signature value matches.
+ */
+bool
+verifyInterestWithHmac(const Interest& interest, const uint8_t* key, size_t keyLen);
+
 /**
  * @brief Authenticated GCM 128 Encryption with associated data.
  *
@@ -1,23 +1,44 @@
 #ifndef NDNMPS_INITIATOR_HPP
 #define NDNMPS_INITIATOR_HPP
 
+#include <deque>
 #include <iostream>
 #include <map>
 #include <tuple>
+#include <unordered_map>
 #include <ndn-cxx/face.hpp>
 #include <ndn-cxx/util/scheduler.hpp>
 #include <ndn-cxx/security/interest-signer.hpp>
 
 #include "bls-helpers.hpp"
+#include "crypto-helpers.hpp"
 #include "mps-signer-list.hpp"
+#include "publication-store.hpp"
+#include "result-poller.hpp"
 #include "schema.hpp"
+#include "session-cache.hpp"
+#include "signature-aggregator.hpp"
 
 namespace ndn {
 namespace mps {
 
 typedef function<void(const Data& data, const Data& signerListData)> SignatureFinishCallback;
+typedef function<void(const std::vector<Data>& data, const Data& signerListData)> BatchSignatureFinishCallback;
 typedef function<void(const std::string& reason)> SignatureFailureCallback;
+typedef function<void(const std::vector<Buffer>& aggregates, const MpsSignerList& signers)> PartialAggregateCallback;
 struct MultiSignGlobalState;
+struct MultiSignPerSignerState;
+
+/**
+ * The state of the in-flight session table of the initiator.
+ */
+struct InitiatorSessionCounters
+{
+  size_t nLiveSessions = 0;
+  size_t nLiveSessionBytes = 0; // estimated memory held by the live sessions
+  uint64_t nExpiredSessions = 0; // sessions failed by their deadline
+  uint64_t nRejectedSessions = 0; // sessions refused because the table was full
+};
 
 /**
  * The signer class class that handles functionality in the multi-signing protocol.
@@ -29,6 +50,39 @@ private:
   Face& m_face;
   Scheduler& m_scheduler;
   security::InterestSigner m_interestSigner;
+  std::shared_ptr<ECDHKeyPool> m_ecdhKeyPool = ECDHKeyPool::getShared();
+  SessionCache m_sessionCache;
+  // one-round-trip signing: max size of the unsigned Data carried inline, and the signers' static ECDH keys
+  size_t m_inlineParameterLimit = 0;
+  std::map<Name, std::vector<uint8_t>> m_signerStaticKeys;
+  // signer key name -> requests waiting for the fetch of its static ECDH key
+  std::map<Name, std::vector<function<void(bool)>>> m_pendingStaticKeyFetches;
+  bool m_isGroupParameterMode = false;
+  ResultPoller m_resultPoller;
+  time::milliseconds m_sessionDeadline = time::seconds(30);
+  size_t m_maxHedgedSigners = 0;
+  bool m_isShareVerificationEnabled = true;
+  // the single route /<prefix>/mps, dispatching to parameter Data by ID and to the publication store
+  ScopedRegisteredPrefixHandle m_mpsPrefixHandle;
+  std::unordered_map<uint64_t, std::function<void(const Interest&)>> m_parameterHandlers;
+  std::deque<std::pair<time::steady_clock::TimePoint, uint64_t>> m_parameterExpiry;
+  // signature info Data, and signed Data if enabled, served to verifiers
+  PublicationStore m_publications;
+  time::milliseconds m_infoDataLifetime = time::minutes(1);
+  bool m_isSignedDataPublished = false;
+  std::vector<ScopedRegisteredPrefixHandle> m_publicationPrefixHandles;
+  // handshake coalescing, with session resumption only: signer key name -> requests waiting for
+  // the full handshake in progress with the signer
+  std::map<Name, std::vector<std::function<void()>>> m_pendingHandshakes;
+  // signers that rejected a request for overload, excluded from replacements until their hint expires
+  std::map<Name, scheduler::ScopedEventId> m_overloadedSigners;
+  // in-flight sessions by ID, each removed once it succeeds, fails, or expires
+  std::map<uint64_t, std::shared_ptr<MultiSignGlobalState>> m_sessions;
+  size_t m_maxSessions = 1024;
+  uint64_t m_lastSessionId = 0;
+  size_t m_liveSessionBytes = 0;
+  uint64_t m_nExpiredSessions = 0;
+  uint64_t m_nRejectedSessions = 0;
 
 public:
   const Name m_prefix;
@@ -48,9 +102,283 @@ public:
   multiPartySign(const Data& unsignedData, const MultipartySchema& schema, const Name& signingKeyName,
                  const SignatureFinishCallback& successCb, const SignatureFailureCallback& failureCb);
 
+  /**
+   * Initiate the multi-party signing of a batch of packets under the same schema.
+   * Each signer gets all packets in one parameter Data and returns all its signature shares in one result,
+   * so the protocol exchange is shared by the whole batch. The signed packets point to one shared
+   * signature info packet, i.e., they are signed by the same signers.
+   * A batch has at most 64 packets and its encoding must fit in one Data packet.
+   * @param unsignedData the unsigned packets.
+   * @param successCb the callback with the signed packets, in the order of @p unsignedData, and the signer list.
+   * @param failureCb the callback then the batch failed to be signed. the reason will be returned.
+   */
+  void
+  multiPartySignBatch(const std::vector<Data>& unsignedData, const MultipartySchema& schema,
+                      const Name& signingKeyName,
+                      const BatchSignatureFinishCallback& successCb, const SignatureFailureCallback& failureCb);
+
+  /**
+   * Aggregate the signature shares of the signers under @p schema over packets that are already prepared
+   * by a parent initiator, without signing or publishing a signature info packet. Used by a SubAggregator.
+   * @param toBeSigned the packets with the signature info of the parent initiator.
+   * @param successCb the callback with the partial aggregate of each packet and the signers aggregated in them.
+   */
+  void
+  aggregatePartial(const std::vector<Data>& toBeSigned, const MultipartySchema& schema, const Name& signingKeyName,
+                   const PartialAggregateCallback& successCb, const SignatureFailureCallback& failureCb);
+
+  /**
+   * Enable the session resumption. A session established by a full handshake with a signer is reused
+   * within @p lifetime (bounded by the signer's offer) and skips the ECDH. Zero (the default) disables it.
+   *
+   * It also coalesces handshakes: concurrent sessions to a signer without a cached session wait for the
+   * first full handshake with it and resume the session it establishes. This is not a connection pool.
+   * Without session resumption, every sign request runs its own handshake.
+   */
+  void
+  setSessionLifetime(time::milliseconds lifetime)
+  {
+    m_sessionCache.setLifetime(lifetime);
+  }
+
+  /**
+   * Enable the one-round-trip signing for unsigned Data whose encoding is no larger than @p limit bytes,
+   * e.g., 4096. The Data is encrypted with the signer's static ECDH key and carried in the sign request,
+   * and the signer answers with the signature share in the same round trip.
+   * Zero (the default) disables it.
+   */
+  void
+  setInlineParameterLimit(size_t limit)
+  {
+    m_inlineParameterLimit = limit;
+  }
+
+  /**
+   * Enable the group mode, in which the unsigned Data is encrypted once under a random content key
+   * and published as one parameter Data fetched by all signers, e.g., from network caches.
+   * Each signer gets the content key wrapped with its own request key.
+   * Only applies to signers that are not asked in one round trip.
+   */
+  void
+  setGroupParameterMode(bool isEnabled)
+  {
+    m_isGroupParameterMode = isEnabled;
+  }
+
+  /**
+   * Serve the signature info Data of finished signings for @p lifetime, so that verifiers can fetch it
+   * from the initiator. Zero disables it.
+   */
+  void
+  setInfoDataLifetime(time::milliseconds lifetime)
+  {
+    m_infoDataLifetime = lifetime;
+  }
+
+  /**
+   * Also serve the signed packets from the publication store, for the same lifetime as the signature
+   * info Data. Their names are not under the initiator prefix, see addPublicationPrefix().
+   */
+  void
+  setSignedDataPublication(bool isEnabled)
+  {
+    m_isSignedDataPublished = isEnabled;
+  }
+
+  /**
+   * Register @p prefix and answer its Interests from the publication store, e.g., the prefix of the signed packets.
+   */
+  void
+  addPublicationPrefix(const Name& prefix);
+
+  /**
+   * The store of the published Data, to set its limits, publish other Data, or read its hit counters.
+   */
+  PublicationStore&
+  getPublicationStore()
+  {
+    return m_publications;
+  }
+
+  /**
+   * Fail a multi-party signing that has not finished within @p deadline after it started (30 seconds
+   * by default). Its outstanding Interests and scheduled fetches are cancelled. Zero means no deadline.
+   */
+  void
+  setSessionDeadline(time::milliseconds deadline)
+  {
+    m_sessionDeadline = deadline;
+  }
+
+  /**
+   * Bound the number of sessions in flight (1024 by default). A signing started when the table is full
+   * fails right away. Zero means no bound.
+   */
+  void
+  setMaxSessions(size_t maxSessions)
+  {
+    m_maxSessions = maxSessions;
+  }
+
+  InitiatorSessionCounters
+  getSessionCounters() const
+  {
+    InitiatorSessionCounters counters;
+    counters.nLiveSessions = m_sessions.size();
+    counters.nLiveSessionBytes = m_liveSessionBytes;
+    counters.nExpiredSessions = m_nExpiredSessions;
+    counters.nRejectedSessions = m_nRejectedSessions;
+    return counters;
+  }
+
+  /**
+   * Enable the hedging for schemas with optional (at-least) signers. Up to @p maxExtraSigners eligible
+   * optional signers are asked in addition to the minimum set, the signing finishes as soon as the shares
+   * received pass the schema, and the remaining requests are cancelled. Zero (the default) disables it.
+   */
+  void
+  setMaxHedgedSigners(size_t maxExtraSigners)
+  {
+    m_maxHedgedSigners = maxExtraSigners;
+  }
+
+  /**
+   * Check the signature shares before the aggregate is released (enabled by default). The shares are
+   * verified in one randomized batch, and the signers of invalid shares are found by bisection and replaced.
+   * The partial aggregates of sub-aggregators are checked even when disabled, since they vouch for the signers
+   * they list.
+   */
+  void
+  setShareVerification(bool isEnabled)
+  {
+    m_isShareVerificationEnabled = isEnabled;
+  }
+
+  /**
+   * The adaptive schedule of result fetches, shared by all sessions of the initiator.
+   */
+  ResultPoller&
+  getResultPoller()
+  {
+    return m_resultPoller;
+  }
+
+  /**
+   * The pool of ephemeral ECDH key pairs used for sign requests.
+   */
+  ECDHKeyPool&
+  getEcdhKeyPool()
+  {
+    return *m_ecdhKeyPool;
+  }
+
+  /**
+   * Replace the process-wide ECDH key pool, e.g. with one of a different capacity.
+   */
+  void
+  setEcdhKeyPool(std::shared_ptr<ECDHKeyPool> pool)
+  {
+    m_ecdhKeyPool = std::move(pool);
+  }
+
 private:
   void
-  performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlobalState> globalState);
+  onMpsInterest(const Interest& interest);
+
+  /**
+   * Serve the parameter Data with the last name component @p id by @p handler, until it is removed or expires.
+   */
+  void
+  addParameterHandler(uint64_t id, const std::function<void(const Interest&)>& handler);
+
+  void
+  publishInfoData(const Data& infoData);
+
+  void
+  onPublicationInterest(const Interest& interest);
+
+  void
+  removeExpiredParameterHandlers();
+
+  /**
+   * Look up the signers of a prepared session and send the sign requests.
+   */
+  void
+  startSession(std::shared_ptr<MultiSignGlobalState> globalState);
+
+  /**
+   * Request the signature share from a signer, in one round trip when possible.
+   */
+  void
+  requestSignature(const Name& signerKeyName, std::shared_ptr<MultiSignGlobalState> globalState);
+
+  /**
+   * Run the sign request with a signer. With session resumption enabled, concurrent requests to a signer
+   * without a session wait for one full handshake and pipeline over the session it establishes,
+   * unless @p canWaitForHandshake is false.
+   */
+  void
+  performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlobalState> globalState,
+             bool canWaitForHandshake = true);
+
+  void
+  performInlineRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlobalState> globalState);
+
+  /**
+   * Fetch and authenticate the static ECDH key published by the signer. Concurrent calls for the same
+   * signer share one fetch.
+   */
+  void
+  fetchSignerStaticKey(const Name& signerKeyName, const function<void(bool)>& callback);
+
+  /**
+   * Add the session to the in-flight session table and schedule its deadline.
+   * @return false if the table is full.
+   */
+  bool
+  addSession(std::shared_ptr<MultiSignGlobalState> globalState);
+
+  /**
+   * Mark the session finished, cancel what is still outstanding, e.g., requests to hedged signers
+   * and scheduled fetches, and remove it from the session table.
+   */
+  void
+  markSessionFinished(std::shared_ptr<MultiSignGlobalState> globalState);
+
+  /**
+   * Release the result poller slot of the result Interest in flight to the signer, if any, once.
+   */
+  void
+  concludeResultFetch(MultiSignPerSignerState& perSignerState);
+
+  /**
+   * Schedule the next result fetch from the signer.
+   */
+  void
+  scheduleResultFetch(time::milliseconds delay,
+                      std::shared_ptr<MultiSignPerSignerState> perSignerState,
+                      std::shared_ptr<MultiSignGlobalState> globalState);
+
+  /**
+   * @param contributors the signers aggregated in the shares of a sub-aggregator, empty for a signer.
+   */
+  void
+  onSignatureShare(const Name& signerKeyName, const std::vector<Buffer>& shares, const MpsSignerList& contributors,
+                   std::shared_ptr<MultiSignGlobalState> globalState);
+
+  /**
+   * Finish the signing if the shares received pass the schema and are valid.
+   */
+  void
+  tryFinishSession(std::shared_ptr<MultiSignGlobalState> globalState);
+
+  /**
+   * Replace a signer that is overloaded right away. It is not chosen as a replacement
+   * until @p retryAfter has passed.
+   */
+  void
+  onOverloadedSigner(const Name& signerKeyName, time::milliseconds retryAfter,
+                     std::shared_ptr<MultiSignGlobalState> globalState);
 
   void
   onUnavailableSigner(const std::string& reason,
@@ -54,6 +54,14 @@ public:
   size_t
   wireEncode(EncodingImpl<TAG>& encoder) const;
 
+public:
+  /**
+   * Append the signers of @p other, e.g., the signer list of a partial aggregate.
+   * @return false if the lists share a signer, whose signature would be counted twice. The list is not changed then.
+   */
+  bool
+  merge(const MpsSignerList& other);
+
 public:
   /**
    * Compare the signer list. The comparison returns true if both side have the same names.
@@ -0,0 +1,97 @@
+#ifndef NDNMPS_PUBLICATION_STORE_HPP
+#define NDNMPS_PUBLICATION_STORE_HPP
+
+#include "common.hpp"
+#include <ndn-cxx/util/time.hpp>
+#include <list>
+#include <map>
+
+namespace ndn {
+namespace mps {
+
+/**
+ * An in-memory LRU store of the Data published by the initiator, e.g., the signature info Data
+ * fetched by verifiers and the signed packets. Interests are answered by name: the index is ordered
+ * by name, so the Data under a prefix are adjacent and CanBePrefix Interests are answered by a range scan.
+ * The store is bounded by entries and by bytes, and each entry expires after its lifetime.
+ */
+class PublicationStore
+{
+public:
+  /**
+   * @param capacity The maximum number of entries. Zero disables the store.
+   * @param maxBytes The maximum total wire size of the entries.
+   */
+  explicit
+  PublicationStore(size_t capacity = 65536, size_t maxBytes = 64 * 1024 * 1024);
+
+  /**
+   * Publish @p data for @p lifetime, replacing the Data of the same name if any.
+   */
+  void
+  insert(const Data& data, time::milliseconds lifetime);
+
+  /**
+   * @return the most recently used Data that satisfies @p interest, or nullptr on a miss.
+   */
+  const Data*
+  find(const Interest& interest);
+
+  bool
+  erase(const Name& dataName);
+
+  void
+  setLimits(size_t capacity, size_t maxBytes);
+
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+  size_t
+  getNBytes() const
+  {
+    return m_nBytes;
+  }
+
+  uint64_t
+  getNHits() const
+  {
+    return m_nHits;
+  }
+
+  uint64_t
+  getNMisses() const
+  {
+    return m_nMisses;
+  }
+
+private:
+  struct Entry
+  {
+    Data m_data;
+    time::steady_clock::TimePoint m_expiry;
+  };
+  using EntryList = std::list<Entry>;
+
+  void
+  eraseEntry(std::map<Name, EntryList::iterator>::iterator indexIt);
+
+  void
+  evictOverLimits();
+
+private:
+  size_t m_capacity;
+  size_t m_maxBytes;
+  size_t m_nBytes = 0;
+  EntryList m_entries; // most recently used at the front
+  std::map<Name, EntryList::iterator> m_index; // by Data name, without the implicit digest
+  uint64_t m_nHits = 0;
+  uint64_t m_nMisses = 0;
+};
+
+}  // namespace mps
+}  // namespace ndn
+
+#endif  // NDNMPS_PUBLICATION_STORE_HPP
@@ -0,0 +1,104 @@
+#ifndef NDNMPS_RESULT_POLLER_HPP
+#define NDNMPS_RESULT_POLLER_HPP
+
+#include "common.hpp"
+#include <ndn-cxx/util/time.hpp>
+#include <deque>
+#include <functional>
+#include <map>
+
+namespace ndn {
+namespace mps {
+
+/**
+ * The options of the adaptive result polling.
+ */
+struct ResultPollerOptions
+{
+  double percentile = 0.75; // the first fetch is issued at this percentile of the observed service times
+  size_t historySize = 32; // service time samples kept per signer
+  time::milliseconds minInterval = time::milliseconds(50); // the first retry interval
+  time::milliseconds maxInterval = time::seconds(2); // the retry interval stops growing here
+  double backoffFactor = 2.0;
+  double jitter = 0.2; // a retry interval is drawn uniformly from [d * (1 - jitter), d * (1 + jitter)]
+  size_t maxOutstanding = 64; // max number of result Interests in flight across all sessions
+};
+
+/**
+ * The schedule of result fetches used by the initiator.
+ *
+ * The poller learns the service time of each signer, i.e., the time from the ACK to the signature share
+ * as reported in the signer's results, and issues the first fetch at a percentile of the past samples
+ * instead of the signer's ResultAfter hint.
+ * Further fetches back off exponentially with jitter so that sessions started together do not poll in lockstep.
+ * A signer advertising ResultAfter of zero holds the fetch itself (long-poll), so it is fetched immediately.
+ */
+class ResultPoller
+{
+public:
+  explicit
+  ResultPoller(const ResultPollerOptions& options = ResultPollerOptions());
+
+  const ResultPollerOptions&
+  getOptions() const
+  {
+    return m_options;
+  }
+
+  void
+  setOptions(const ResultPollerOptions& options)
+  {
+    m_options = options;
+  }
+
+  void
+  recordServiceTime(const Name& signerKeyName, time::milliseconds serviceTime);
+
+  /**
+   * @return the delay of the first result fetch. @p resultAfter is used until the signer has a history.
+   */
+  time::milliseconds
+  getFirstDelay(const Name& signerKeyName, time::milliseconds resultAfter) const;
+
+  /**
+   * @return the jittered delay of the fetch after @p nRetries fetches answered with Processing.
+   */
+  time::milliseconds
+  getRetryDelay(size_t nRetries, time::milliseconds resultAfter) const;
+
+  /**
+   * Run @p fetch now if fewer than maxOutstanding result Interests are in flight, or queue it.
+   * Every submitted fetch must be concluded by onFetchDone(), whether an Interest is sent or not.
+   */
+  void
+  submit(const std::function<void()>& fetch);
+
+  /**
+   * Conclude a fetch and run the next queued one, if any.
+   */
+  void
+  onFetchDone();
+
+  size_t
+  getNOutstanding() const
+  {
+    return m_nOutstanding;
+  }
+
+  size_t
+  getNQueued() const
+  {
+    return m_queue.size();
+  }
+
+private:
+  ResultPollerOptions m_options;
+  std::map<Name, std::deque<time::milliseconds>> m_serviceTimes;
+  size_t m_nOutstanding = 0;
+  std::deque<std::function<void()>> m_queue;
+};
+
+}  // namespace mps
+}  // namespace ndn
+
+#endif  // NDNMPS_RESULT_POLLER_HPP
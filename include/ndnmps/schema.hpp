@@ -163,6 +163,14 @@ public:
   std::tuple<MpsSignerList, std::vector<Name>>
   replaceSigner(const MpsSignerList& signers, const Name& unavailableKey, const MultipartySchema& schema) const;
 
+  /**
+   * @brief Get extra available optional signers to be asked together with @p signers.
+   * @param maxExtraSigners The max number of signers returned.
+   * @return the optional signers that are not in @p signers, in the order of the optional patterns.
+   */
+  std::vector<Name>
+  getHedgeSigners(const MultipartySchema& schema, const MpsSignerList& signers, size_t maxExtraSigners) const;
+
   BLSPublicKey
   aggregateKey(const MpsSignerList& signers) const;
 
@@ -0,0 +1,99 @@
+#ifndef NDNMPS_SESSION_CACHE_HPP
+#define NDNMPS_SESSION_CACHE_HPP
+
+#include "common.hpp"
+#include <ndn-cxx/util/time.hpp>
+#include <array>
+#include <map>
+
+namespace ndn {
+namespace mps {
+
+/**
+ * A session secret established by a full ECDH handshake between an initiator and a signer.
+ * Per-request AES and HMAC keys are derived from the secret and a request nonce,
+ * so that returning pairs can skip the P-256 operations.
+ */
+struct ResumableSession
+{
+  uint64_t m_id = 0;
+  std::array<uint8_t, 32> m_secret;
+  Name m_peer; // initiator key name on the signer side, signer key name on the initiator side
+  time::steady_clock::TimePoint m_expiry;
+};
+
+/**
+ * The cache of resumable sessions, indexed by session ID and by peer name.
+ * Entries are dropped once their lifetime is over, which bounds the forward secrecy of the session.
+ */
+class SessionCache
+{
+public:
+  /**
+   * @param lifetime The lifetime of a session. Zero disables the session resumption.
+   * @param capacity The maximum number of cached sessions.
+   */
+  explicit
+  SessionCache(time::milliseconds lifetime = time::milliseconds(0), size_t capacity = 1024);
+
+  bool
+  isEnabled() const
+  {
+    return m_lifetime > time::milliseconds(0);
+  }
+
+  time::milliseconds
+  getLifetime() const
+  {
+    return m_lifetime;
+  }
+
+  void
+  setLifetime(time::milliseconds lifetime)
+  {
+    m_lifetime = lifetime;
+  }
+
+  /**
+   * Insert a session. The peer index will point to this session, while older sessions
+   * with the same peer stay valid until they expire.
+   */
+  void
+  insert(const ResumableSession& session);
+
+  /**
+   * @return the unexpired session with the given ID, or nullptr.
+   */
+  const ResumableSession*
+  find(uint64_t sessionId);
+
+  /**
+   * @return the latest unexpired session with the given peer, or nullptr.
+   */
+  const ResumableSession*
+  findByPeer(const Name& peer);
+
+  void
+  erase(uint64_t sessionId);
+
+  size_t
+  size() const
+  {
+    return m_sessions.size();
+  }
+
+private:
+  void
+  removeExpired();
+
+private:
+  time::milliseconds m_lifetime;
+  size_t m_capacity;
+  std::map<uint64_t, ResumableSession> m_sessions;
+  std::map<Name, uint64_t> m_peerIndex;
+};
+
+}  // namespace mps
+}  // namespace ndn
+
+#endif  // NDNMPS_SESSION_CACHE_HPP
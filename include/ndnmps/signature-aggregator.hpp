@@ -0,0 +1,75 @@
+#ifndef NDNMPS_SIGNATURE_AGGREGATOR_HPP
+#define NDNMPS_SIGNATURE_AGGREGATOR_HPP
+
+#include "bls-helpers.hpp"
+#include <map>
+#include <vector>
+
+namespace ndn {
+namespace mps {
+
+/**
+ * The running aggregate of the signature shares of one multi-party signing.
+ *
+ * Each share is deserialized and added to the aggregate when it arrives, so that the signature is ready
+ * right after the last share. The contribution of each signer is kept so that it can be subtracted,
+ * e.g., when the signer is replaced.
+ */
+class SignatureAggregator
+{
+public:
+  /**
+   * Add the share of @p signerKeyName, replacing the earlier share of the same signer if any.
+   * @return false if @p share cannot be decoded. The aggregate is not changed.
+   */
+  bool
+  add(const Name& signerKeyName, const Buffer& share);
+
+  /**
+   * Subtract the share of @p signerKeyName from the aggregate, if it has been added.
+   */
+  void
+  remove(const Name& signerKeyName);
+
+  bool
+  contains(const Name& signerKeyName) const
+  {
+    return m_contributions.count(signerKeyName) > 0;
+  }
+
+  size_t
+  size() const
+  {
+    return m_contributions.size();
+  }
+
+  /**
+   * @return the signers whose shares are in the aggregate, in order.
+   */
+  std::vector<Name>
+  getSigners() const;
+
+  /**
+   * @return the serialized aggregate signature.
+   * @throw std::runtime_error if no share has been added.
+   */
+  Buffer
+  getSignature() const;
+
+  /**
+   * Check all shares over @p data in one randomized batch, see ndnBLSFindInvalidShares().
+   * @param trustedKeys the public keys of the signers. A signer without a key is invalid.
+   * @return the signers whose shares are invalid, empty if the aggregate is valid.
+   */
+  std::vector<Name>
+  findInvalidShares(const std::map<Name, BLSPublicKey>& trustedKeys, const Data& data) const;
+
+private:
+  std::map<Name, BLSSignature> m_contributions;
+  BLSSignature m_aggregate;
+};
+
+}  // namespace mps
+}  // namespace ndn
+
+#endif  // NDNMPS_SIGNATURE_AGGREGATOR_HPP
@@ -0,0 +1,104 @@
+#ifndef NDNMPS_SIGNATURE_CACHE_HPP
+#define NDNMPS_SIGNATURE_CACHE_HPP
+
+#include "common.hpp"
+#include <ndn-cxx/util/time.hpp>
+#include <array>
+#include <list>
+#include <map>
+
+namespace ndn {
+namespace mps {
+
+using SignedPortionDigest = std::array<uint8_t, 32>;
+
+/**
+ * Compute the SHA-256 digest of the signed portion of an unsigned Data that already has its signature info.
+ */
+SignedPortionDigest
+computeSignedPortionDigest(const Data& dataWithInfo);
+
+/**
+ * An LRU cache of signature shares generated by a signer, keyed by the key name and the
+ * digest of the signed portion. Retried or duplicated sign requests can be answered
+ * from the cache without signing again. The cache is bounded by entries and by TTL.
+ */
+class SignatureCache
+{
+public:
+  /**
+   * @param capacity The maximum number of entries. Zero disables the cache.
+   * @param ttl The period an entry stays valid after it is inserted.
+   */
+  explicit
+  SignatureCache(size_t capacity = 1024, time::milliseconds ttl = time::seconds(60));
+
+  /**
+   * @return the cached signature value, or nullptr on a miss.
+   */
+  const Buffer*
+  find(const Name& keyName, const SignedPortionDigest& digest);
+
+  void
+  insert(const Name& keyName, const SignedPortionDigest& digest, const Buffer& signatureValue);
+
+  /**
+   * Remove the entries of a key, e.g., when the key is replaced or removed.
+   * @return the number of entries removed.
+   */
+  size_t
+  eraseKey(const Name& keyName);
+
+  void
+  setCapacity(size_t capacity);
+
+  void
+  setTtl(time::milliseconds ttl)
+  {
+    m_ttl = ttl;
+  }
+
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+  uint64_t
+  getNHits() const
+  {
+    return m_nHits;
+  }
+
+  uint64_t
+  getNMisses() const
+  {
+    return m_nMisses;
+  }
+
+private:
+  using Key = std::pair<Name, SignedPortionDigest>;
+
+  struct Entry
+  {
+    Key m_key;
+    Buffer m_signatureValue;
+    time::steady_clock::TimePoint m_expiry;
+  };
+
+  void
+  evictOverCapacity();
+
+private:
+  size_t m_capacity;
+  time::milliseconds m_ttl;
+  std::list<Entry> m_entries; // most recently used at the front
+  std::map<Key, std::list<Entry>::iterator> m_index;
+  uint64_t m_nHits = 0;
+  uint64_t m_nMisses = 0;
+};
+
+}  // namespace mps
+}  // namespace ndn
+
+#endif  // NDNMPS_SIGNATURE_CACHE_HPP
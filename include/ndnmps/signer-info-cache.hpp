@@ -0,0 +1,90 @@
+#ifndef NDNMPS_SIGNER_INFO_CACHE_HPP
+#define NDNMPS_SIGNER_INFO_CACHE_HPP
+
+#include "mps-signer-list.hpp"
+#include <ndn-cxx/util/time.hpp>
+#include <list>
+#include <map>
+
+namespace ndn {
+namespace mps {
+
+/**
+ * An LRU cache of the signer lists decoded from signature info Data, keyed by the key locator name
+ * of the signed packets. Packets signed in the same signing (e.g., a batch) share the entry,
+ * so the signature info Data is fetched and decoded once.
+ */
+class SignerInfoCache
+{
+public:
+  /**
+   * @param capacity The maximum number of entries. Zero disables the cache.
+   * @param maxTtl The longest period an entry stays valid after it is inserted.
+   */
+  explicit
+  SignerInfoCache(size_t capacity = 1024, time::milliseconds maxTtl = time::minutes(5));
+
+  /**
+   * @return the cached signer list, or nullptr on a miss.
+   */
+  const MpsSignerList*
+  find(const Name& keyLocatorName);
+
+  /**
+   * Cache @p signers until the freshness period of their signature info Data is over, at most the maximum TTL.
+   * A Data without a freshness period is cached for the maximum TTL.
+   */
+  void
+  insert(const Name& keyLocatorName, const MpsSignerList& signers, time::milliseconds freshnessPeriod);
+
+  void
+  setCapacity(size_t capacity);
+
+  void
+  setMaxTtl(time::milliseconds maxTtl)
+  {
+    m_maxTtl = maxTtl;
+  }
+
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+  uint64_t
+  getNHits() const
+  {
+    return m_nHits;
+  }
+
+  uint64_t
+  getNMisses() const
+  {
+    return m_nMisses;
+  }
+
+private:
+  struct Entry
+  {
+    Name m_keyLocatorName;
+    MpsSignerList m_signers;
+    time::steady_clock::TimePoint m_expiry;
+  };
+
+  void
+  evictOverCapacity();
+
+private:
+  size_t m_capacity;
+  time::milliseconds m_maxTtl;
+  std::list<Entry> m_entries; // most recently used at the front
+  std::map<Name, std::list<Entry>::iterator> m_index;
+  uint64_t m_nHits = 0;
+  uint64_t m_nMisses = 0;
+};
+
+}  // namespace mps
+}  // namespace ndn
+
+#endif  // NDNMPS_SIGNER_INFO_CACHE_HPP
@@ -5,16 +5,88 @@
 #include "ndnmps/mps-signer-list.hpp"
 #include "ndnmps/schema.hpp"
 #include "ndnmps/crypto-helpers.hpp"
+#include "ndnmps/session-cache.hpp"
+#include "ndnmps/signature-cache.hpp"
+#include "ndnmps/token-bucket.hpp"
 #include <ndn-cxx/face.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
 #include <iostream>
+#include <list>
 #include <map>
 #include <tuple>
+#include <unordered_map>
 
 namespace ndn {
 namespace mps {
 
 using VerifyToBeSignedCallback = function<bool(const Data&)>;
 using VerifySignRequestCallback = function<bool(const Interest&)>;
+/**
+ * The completion handler of an asynchronous policy check. It may be invoked from any thread, once.
+ */
+using PolicyDecisionCallback = function<void(bool isAccepted)>;
+using AsyncVerifyToBeSignedCallback = function<void(const Data&, const PolicyDecisionCallback&)>;
+using AsyncVerifySignRequestCallback = function<void(const Interest&, const PolicyDecisionCallback&)>;
+/**
+ * The completion handler of a delegated signing: the signature shares, one per packet of the batch,
+ * and the signers aggregated in them. No shares fail the request. It must be invoked on the face's thread.
+ */
+using DelegatedSignCompletion = function<void(const std::vector<Buffer>& shares, const MpsSignerList& signers)>;
+using DelegatedSignCallback = function<void(const std::vector<Data>& batch, const DelegatedSignCompletion&)>;
+struct SignRequestState;
+
+/**
+ * The limits on the per-request state kept by the signer.
+ * When a limit is exceeded, the oldest requests are evicted first. A request that grows past maxPendingBytes
+ * by itself, e.g., with a large batch, fails with Unavailable (503).
+ *
+ * The admission limits shed load before any state is created or any policy is checked: a sign request over
+ * the rate of its initiator or over the queue limits is rejected with Unavailable (503) and a RetryAfter hint.
+ * An initiator is only charged, and given a bucket, once the sign request policy accepts its request.
+ */
+struct SignerLimits
+{
+  size_t maxPendingRequests = 1024; // max number of in-flight sign requests
+  size_t maxPendingBytes = 16 * 1024 * 1024; // max bytes held by in-flight sign requests
+  time::milliseconds requestLifetime = time::seconds(8); // a request state expires after this period
+  double initiatorRate = 0; // sign requests per second admitted from one initiator, zero for unlimited
+  double initiatorBurst = 16; // sign requests admitted at once from one initiator
+  size_t maxQueuedRequests = 0; // requests in the table or in a policy check above which new ones are rejected,
+                                // zero for unlimited
+  size_t maxPendingPolicyChecks = 1024; // asynchronous policy checks above which new requests are rejected,
+                                        // a batch counts one check per packet
+};
+
+/**
+ * The counters exported by the signer for monitoring.
+ */
+struct SignerCounters
+{
+  size_t nPendingRequests = 0; // current number of entries in the request table
+  size_t nPendingBytes = 0; // current bytes held by entries in the request table
+  uint64_t nExpiredRequests = 0; // entries removed because their deadline passed
+  uint64_t nEvictedRequests = 0; // entries removed because a limit was exceeded
+  uint64_t nRejectedRequests = 0; // sign requests rejected by the admission control
+  size_t nPendingPolicyChecks = 0; // asynchronous policy checks waiting for a decision
+  uint64_t nPolicyTimeouts = 0; // asynchronous policy checks denied because no decision came in time
+};
+
+/**
+ * A BLS key hosted by the signer, with its own static ECDH key for one-round-trip sign requests.
+ *
+ * The static ECDH key is replaced every freshness period of its Data. The replaced key still
+ * decrypts sign requests until the next replacement, for initiators holding the old one.
+ */
+struct HostedKey
+{
+  Name m_keyName;
+  BLSSecretKey m_sk;
+  BLSPublicKey m_pk;
+  std::unique_ptr<ECDHState> m_staticEcdh;
+  std::unique_ptr<ECDHState> m_previousStaticEcdh;
+  Data m_staticEcdhKeyData;
+  scheduler::ScopedEventId m_rotationEvent;
+};
 
 /**
  * The signer class class that handles functionality in the multi-signing protocol.
@@ -27,11 +99,40 @@ private:
   KeyChain& m_keyChain;
   VerifyToBeSignedCallback m_verifyToBeSignedCallback;
   VerifySignRequestCallback m_verifySignRequestCallback;
-  RegisteredPrefixHandle m_signRequestHandle;
+  AsyncVerifyToBeSignedCallback m_asyncVerifyToBeSignedCallback;
+  AsyncVerifySignRequestCallback m_asyncVerifySignRequestCallback;
+  DelegatedSignCallback m_delegatedSignCallback;
+  RegisteredPrefixHandle m_prefixHandle;
+  InterestFilterHandle m_signRequestHandle;
+  InterestFilterHandle m_ecdhKeyHandle;
+  Scheduler m_scheduler;
+  std::shared_ptr<ECDHKeyPool> m_ecdhKeyPool = ECDHKeyPool::getShared();
+  SessionCache m_sessionCache;
+  SignatureCache m_signatureCache;
 
-  // Self key pair
-  BLSSecretKey m_sk;
-  BLSPublicKey m_pk;
+  // in-flight sign requests, oldest at the front of m_requestOrder
+  std::map<uint64_t, std::shared_ptr<SignRequestState>> m_requests;
+  std::list<uint64_t> m_requestOrder;
+  SignerLimits m_limits;
+  SignerCounters m_counters;
+  TokenBucketTable m_initiatorBuckets;
+
+  // asynchronous policy checks waiting for a decision
+  struct PendingPolicyCheck
+  {
+    PolicyDecisionCallback m_onDecision;
+    scheduler::ScopedEventId m_timeoutEvent;
+  };
+  std::map<uint64_t, PendingPolicyCheck> m_policyChecks;
+  uint64_t m_lastPolicyCheckId = 0;
+  time::milliseconds m_policyTimeout = time::seconds(2);
+  // expires with the signer, so that late decisions posted to the face's thread are dropped
+  std::shared_ptr<char> m_lifetimeToken;
+  time::milliseconds m_longPollHold = time::milliseconds(0);
+
+  // hosted key pairs by key name, the latest key of each identity, and the default key
+  std::unordered_map<Name, HostedKey> m_keys;
+  std::unordered_map<Name, Name> m_identityKeys;
   Name m_keyName;
 
 public:
@@ -57,7 +158,7 @@ public:
   const BLSPublicKey&
   getPublicKey()
   {
-    return m_pk;
+    return m_keys.at(m_keyName).m_pk;
   }
 
   Name
@@ -66,9 +167,275 @@ public:
     return m_keyName;
   }
 
+  /**
+   * Host a key with the given secret key, or replace the hosted one. The key must be under the signer prefix,
+   * e.g., /prefix/alice/KEY/1, so that its sign requests reach the signer without another prefix registration.
+   * All hosted keys share the request table, the limits, the caches and the ECDH key pool.
+   * @return the public key.
+   * @throw std::runtime_error The key name is not under the signer prefix.
+   */
+  const BLSPublicKey&
+  addKey(const Name& keyName, const BLSSecretKey& sk);
+
+  /**
+   * Host a key with a randomly generated secret key.
+   */
+  const BLSPublicKey&
+  addKey(const Name& keyName);
+
+  /**
+   * Stop hosting a key and drop its pending requests. The default key cannot be removed.
+   * @return false if the key is not hosted.
+   */
+  bool
+  removeKey(const Name& keyName);
+
+  size_t
+  getNKeys() const
+  {
+    return m_keys.size();
+  }
+
+  /**
+   * Set the limits of the request table. Takes effect on the next insertion.
+   */
+  void
+  setLimits(const SignerLimits& limits)
+  {
+    m_limits = limits;
+    m_initiatorBuckets.setRate(limits.initiatorRate, limits.initiatorBurst);
+  }
+
+  const SignerLimits&
+  getLimits() const
+  {
+    return m_limits;
+  }
+
+  const SignerCounters&
+  getCounters() const
+  {
+    return m_counters;
+  }
+
+  /**
+   * Enable the session resumption. After a full handshake, the initiator may resume the session
+   * within @p lifetime and skip the ECDH. Zero (the default) disables the session resumption.
+   */
+  void
+  setSessionLifetime(time::milliseconds lifetime)
+  {
+    m_sessionCache.setLifetime(lifetime);
+  }
+
+  /**
+   * Check the unsigned Data asynchronously, e.g., against a database, instead of with the synchronous callback.
+   * The signer keeps the request while the decision is pending and serves other requests meanwhile.
+   */
+  void
+  setAsyncVerifyToBeSignedCallback(const AsyncVerifyToBeSignedCallback& callback)
+  {
+    m_asyncVerifyToBeSignedCallback = callback;
+  }
+
+  /**
+   * Check the sign request asynchronously instead of with the synchronous callback.
+   */
+  void
+  setAsyncVerifySignRequestCallback(const AsyncVerifySignRequestCallback& callback)
+  {
+    m_asyncVerifySignRequestCallback = callback;
+  }
+
+  /**
+   * An asynchronous policy check without a decision after @p timeout denies the request.
+   */
+  void
+  setPolicyTimeout(time::milliseconds timeout)
+  {
+    m_policyTimeout = timeout;
+  }
+
+  /**
+   * Produce the signature shares of accepted requests with @p callback instead of the hosted key,
+   * e.g., by a subtree of signers (see SubAggregator). The result carries the shares and the list of
+   * signers they aggregate. Delegated requests are not answered in one round trip.
+   */
+  void
+  setDelegatedSignCallback(const DelegatedSignCallback& callback)
+  {
+    m_delegatedSignCallback = callback;
+  }
+
+  /**
+   * Enable the long-poll result delivery. A result Interest that arrives before the signature share
+   * is ready is held for up to @p maxHold (and always answered before the Interest expires), so the
+   * share is returned as soon as it is generated. The ACK then advertises ResultAfter of zero.
+   * Zero (the default) disables the long-poll and the initiator polls every second.
+   */
+  void
+  setLongPollHold(time::milliseconds maxHold)
+  {
+    m_longPollHold = maxHold;
+  }
+
+  /**
+   * The cache of generated signature shares, which answers retried or duplicated sign requests.
+   * Also exposes the hit and miss counts.
+   */
+  SignatureCache&
+  getSignatureCache()
+  {
+    return m_signatureCache;
+  }
+
+  /**
+   * The pool of ephemeral ECDH key pairs used to answer sign requests.
+   */
+  ECDHKeyPool&
+  getEcdhKeyPool()
+  {
+    return *m_ecdhKeyPool;
+  }
+
+  /**
+   * Replace the process-wide ECDH key pool, e.g. with one of a different capacity.
+   */
+  void
+  setEcdhKeyPool(std::shared_ptr<ECDHKeyPool> pool)
+  {
+    m_ecdhKeyPool = std::move(pool);
+  }
+
 private:
   void
   onSignRequest(const Interest&);
+
+  void
+  onSignRequestDecision(const Interest&, bool isAccepted);
+
+  void
+  onToBeSignedDecision(uint64_t requestId, const std::vector<Data>& batch, bool isAccepted);
+
+  void
+  onDelegatedShares(uint64_t requestId, size_t batchSize,
+                    const std::vector<Buffer>& shares, const MpsSignerList& signers);
+
+  /**
+   * Group mode: decrypt the shared parameter Data once both it and the content key have arrived.
+   */
+  void
+  onGroupParameterPart(uint64_t requestId);
+
+  void
+  replyInlineSignRequest(const Interest& interest, const HostedKey& key, const Data& unsignedData,
+                         const std::array<uint8_t, 48>& aesAndHmac, bool isAccepted);
+
+  /**
+   * Check the unsigned Data with the asynchronous policy if set, otherwise with the synchronous one.
+   */
+  void
+  checkToBeSigned(const Data& unsignedData, const PolicyDecisionCallback& onDecision);
+
+  /**
+   * Check every packet of a batch, which is accepted only if all packets are accepted.
+   * The checks of a batch are admitted together, and the ones still pending are cancelled once it is decided.
+   */
+  void
+  checkToBeSignedBatch(const std::vector<Data>& batch, const PolicyDecisionCallback& onDecision);
+
+  /**
+   * Start an asynchronous policy check. @p onDecision is invoked on the face's thread with the decision,
+   * or with false once the policy timeout is over.
+   * @return the ID of the check, or zero if it is denied right away because too many checks are pending.
+   */
+  uint64_t
+  runPolicyCheck(const function<void(const PolicyDecisionCallback&)>& check,
+                 const PolicyDecisionCallback& onDecision);
+
+  void
+  concludePolicyCheck(uint64_t checkId, bool isAccepted);
+
+  /**
+   * Drop a pending policy check without invoking its decision callback. A late decision is ignored.
+   */
+  void
+  cancelPolicyCheck(uint64_t checkId);
+
+  /**
+   * Handle a one-round-trip sign request, which carries the encrypted unsigned Data inline
+   * and is answered with the encrypted signature share.
+   */
+  void
+  onInlineSignRequest(const Interest&, const HostedKey& key);
+
+  void
+  onStaticEcdhKeyRequest(const Interest&);
+
+  /**
+   * Find the hosted key that a request targets: the SignerKeyName carried in the parameters,
+   * or else the latest key of the identity in the Interest name.
+   */
+  /**
+   * Replace the static ECDH key of a hosted key and publish the new one, keeping the previous
+   * key for the requests encrypted to it. Schedules the next replacement.
+   */
+  void
+  rotateStaticEcdhKey(HostedKey& key);
+
+  const HostedKey*
+  findTargetKey(const Interest& interest) const;
+
+  /**
+   * Generate the signature share of the unsigned Data, reusing the cached share if any.
+   */
+  Buffer
+  generateSignature(const HostedKey& key, const Data& unsignedData);
+
+  /**
+   * Reject a sign request with Unavailable and a hint of when to retry.
+   */
+  void
+  rejectOverloaded(const Interest& interest, const HostedKey& key, time::milliseconds retryAfter);
+
+  void
+  onResultRequest(uint64_t requestId, const Interest& interest);
+
+  /**
+   * Answer the held result Interest of the request, if any, with its current status.
+   */
+  void
+  answerHeldResultInterest(const std::shared_ptr<SignRequestState>& statePtr);
+
+  void
+  replyResult(const std::shared_ptr<SignRequestState>& statePtr, const Name& interestName);
+
+  /**
+   * The ResultAfter advertised to initiators: zero when long-poll is enabled.
+   */
+  time::milliseconds
+  getResultAfter() const;
+
+NDNMPS_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  std::shared_ptr<SignRequestState>
+  findRequest(uint64_t requestId) const;
+
+  void
+  insertRequest(uint64_t requestId, const std::shared_ptr<SignRequestState>& state);
+
+  /**
+   * Update the accounted size of a request, e.g., after its signature value is generated.
+   * The oldest other requests are evicted if the byte limit is exceeded.
+   * @return false, leaving the size unchanged, if the request alone exceeds the byte limit.
+   */
+  bool
+  resizeRequest(const std::shared_ptr<SignRequestState>& state, size_t newSize);
+
+  /**
+   * Remove the request from the table and unregister its result prefix.
+   */
+  void
+  eraseRequest(uint64_t requestId);
 };
 
 }  // namespace mps
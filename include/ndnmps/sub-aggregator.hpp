@@ -0,0 +1,73 @@
+#ifndef NDNMPS_SUB_AGGREGATOR_HPP
+#define NDNMPS_SUB_AGGREGATOR_HPP
+
+#include "initiator.hpp"
+#include "signer.hpp"
+
+namespace ndn {
+namespace mps {
+
+/**
+ * An inner node of an aggregation tree for large signer committees.
+ *
+ * To its parent initiator, the sub-aggregator is a signer: the parent lists its key name in the schema
+ * and sends it one sign request. The sub-aggregator then runs the signing with the signers of its subtree
+ * (which may be sub-aggregators again) over the same packets, and answers with the partial aggregate
+ * of each packet and the list of signers in it. The parent merges the lists of its children, so that
+ * its fan-in stays at the number of children instead of the size of the committee.
+ *
+ * The parent checks a partial aggregate with the aggregate key of the signers listed, so it must trust
+ * the keys of all signers in the tree, as a verifier of the final signature does. A partial aggregate
+ * listing an untrusted signer is rejected.
+ *
+ * The signer list published by the root names the leaves, not the sub-aggregators. The schema passed to
+ * multiPartySign() at the root names the sub-aggregators, while the root's schema container must hold the
+ * schema a verifier applies to the packets, naming the leaves: the root only releases a signature that
+ * passes it.
+ */
+class SubAggregator
+{
+public:
+  /**
+   * @param prefix the routable prefix, serving both the sign requests from the parent
+   *        and the parameter Data fetched by the subtree.
+   * @param keyName the key name the parent addresses, under @p prefix.
+   * @param signingKeyName the key that signs the sign requests to the subtree.
+   * @param subtreeSchema the signers of the subtree, whose keys are set in getInitiator().m_schemaContainer.
+   */
+  SubAggregator(const Name& prefix, Face& face, KeyChain& keyChain, Scheduler& scheduler,
+                const Name& keyName, const Name& signingKeyName, const MultipartySchema& subtreeSchema);
+
+  /**
+   * The signer role facing the parent, e.g., to set the policy checks and limits.
+   */
+  BLSSigner&
+  getSigner()
+  {
+    return m_signer;
+  }
+
+  /**
+   * The initiator role facing the subtree.
+   */
+  MPSInitiator&
+  getInitiator()
+  {
+    return m_initiator;
+  }
+
+private:
+  void
+  aggregate(const std::vector<Data>& batch, const DelegatedSignCompletion& onShares);
+
+private:
+  BLSSigner m_signer;
+  MPSInitiator m_initiator;
+  MultipartySchema m_subtreeSchema;
+  Name m_signingKeyName;
+};
+
+}  // namespace mps
+}  // namespace ndn
+
+#endif  // NDNMPS_SUB_AGGREGATOR_HPP
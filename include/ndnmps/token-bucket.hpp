@@ -0,0 +1,78 @@
+#ifndef NDNMPS_TOKEN_BUCKET_HPP
+#define NDNMPS_TOKEN_BUCKET_HPP
+
+#include "common.hpp"
+#include <ndn-cxx/util/time.hpp>
+#include <map>
+
+namespace ndn {
+namespace mps {
+
+/**
+ * Per-peer token buckets used by the signer to rate-limit sign requests from each initiator.
+ * Each bucket holds at most @p burst tokens and is refilled at @p rate tokens per second.
+ */
+class TokenBucketTable
+{
+public:
+  /**
+   * @param rate The refill rate in tokens per second. Zero disables the rate limiting.
+   * @param burst The capacity of each bucket.
+   * @param capacity The maximum number of buckets. Full (idle) buckets are dropped first when exceeded.
+   */
+  explicit
+  TokenBucketTable(double rate = 0, double burst = 16, size_t capacity = 4096);
+
+  bool
+  isEnabled() const
+  {
+    return m_rate > 0;
+  }
+
+  void
+  setRate(double rate, double burst);
+
+  /**
+   * Take one token from the bucket of @p peer.
+   * @return zero if the token is taken, otherwise the time until a token will be available.
+   */
+  time::milliseconds
+  tryAcquire(const Name& peer);
+
+  /**
+   * Check the bucket of @p peer without taking a token or creating a bucket, e.g., before the peer is authenticated.
+   * @return zero if a token is available or @p peer has no bucket, otherwise the time until a token will be available.
+   */
+  time::milliseconds
+  getWaitTime(const Name& peer) const;
+
+  size_t
+  size() const
+  {
+    return m_buckets.size();
+  }
+
+private:
+  struct Bucket
+  {
+    double m_tokens;
+    time::steady_clock::TimePoint m_lastRefill;
+  };
+
+  void
+  refill(Bucket& bucket, time::steady_clock::TimePoint now) const;
+
+  void
+  removeFullBuckets(time::steady_clock::TimePoint now);
+
+private:
+  double m_rate;
+  double m_burst;
+  size_t m_capacity;
+  std::map<Name, Bucket> m_buckets;
+};
+
+}  // namespace mps
+}  // namespace ndn
+
+#endif  // NDNMPS_TOKEN_BUCKET_HPP
@@ -0,0 +1,113 @@
+#ifndef NDNMPS_VERIFIER_ENGINE_HPP
+#define NDNMPS_VERIFIER_ENGINE_HPP
+
+#include "bls-helpers.hpp"
+#include "mps-signer-list.hpp"
+#include "schema.hpp"
+#include <boost/asio/io_service.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ndn {
+namespace mps {
+
+/**
+ * A pool of worker threads that verifies BLS signatures off the I/O thread.
+ *
+ * Each worker owns a task queue. Tasks are spread over the queues round-robin, a worker takes the newest
+ * task of its own queue and, once it runs dry, steals the oldest task of another queue. A worker that finds
+ * no task in any queue sleeps until the next task is queued. The result of each task is posted back to the
+ * I/O thread, where the callback is invoked.
+ *
+ * The schema and trusted keys are read from an immutable snapshot, which is swapped atomically by
+ * setSchemaContainer(), so workers never lock to read them.
+ */
+class VerifierEngine : noncopyable
+{
+public:
+  /**
+   * @param io the I/O thread's io_service, where the callbacks are invoked.
+   * @param nThreads the number of worker threads, at least one.
+   */
+  VerifierEngine(boost::asio::io_service& io, size_t nThreads);
+
+  /**
+   * Stop and join the workers. The callbacks of the tasks not finished yet are not invoked.
+   */
+  ~VerifierEngine();
+
+  /**
+   * Publish a copy of @p container as the snapshot used by the tasks submitted from now on.
+   */
+  void
+  setSchemaContainer(const MultipartySchemaContainer& container);
+
+  std::shared_ptr<const MultipartySchemaContainer>
+  getSchemaSnapshot() const
+  {
+    return std::atomic_load(&m_schema);
+  }
+
+  /**
+   * Check @p signerList against the schema snapshot and verify the aggregate signature of @p data on a worker.
+   * Must be called on the I/O thread, and @p data must be encoded.
+   * @param callback invoked on the I/O thread with the result.
+   */
+  void
+  verify(const Data& data, const MpsSignerList& signerList, const function<void(bool)>& callback);
+
+  size_t
+  getNThreads() const
+  {
+    return m_threads.size();
+  }
+
+  /**
+   * @return the number of tasks taken from the queue of another worker.
+   */
+  uint64_t
+  getNSteals() const
+  {
+    return m_nSteals;
+  }
+
+private:
+  struct TaskQueue
+  {
+    std::mutex m_mutex;
+    std::deque<std::function<void()>> m_tasks;
+  };
+
+  void
+  submit(std::function<void()> task);
+
+  bool
+  takeTask(size_t workerIndex, std::function<void()>& task);
+
+  void
+  runWorker(size_t workerIndex);
+
+private:
+  boost::asio::io_service& m_io;
+  std::shared_ptr<const MultipartySchemaContainer> m_schema; // read and swapped with std::atomic_load/store
+  std::vector<std::unique_ptr<TaskQueue>> m_queues;
+  std::vector<std::thread> m_threads;
+  size_t m_nextQueue = 0; // only used on the I/O thread
+  uint64_t m_nSubmitted = 0; // tasks queued so far, guarded by m_idleMutex; an idle worker waits for it to change
+  std::atomic<uint64_t> m_nSteals{0};
+  std::atomic<bool> m_isStopped{false};
+  std::mutex m_idleMutex;
+  std::condition_variable m_idleCondition;
+  // expires with the engine, so that results posted to the I/O thread afterwards are dropped
+  std::shared_ptr<char> m_lifetimeToken;
+};
+
+}  // namespace mps
+}  // namespace ndn
+
+#endif  // NDNMPS_VERIFIER_ENGINE_HPP
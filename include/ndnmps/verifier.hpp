@@ -5,10 +5,13 @@
 #include <map>
 #include <tuple>
 #include <ndn-cxx/face.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
 
 #include "ndnmps/bls-helpers.hpp"
 #include "ndnmps/mps-signer-list.hpp"
 #include "ndnmps/schema.hpp"
+#include "ndnmps/signer-info-cache.hpp"
+#include "ndnmps/verifier-engine.hpp"
 
 namespace ndn {
 namespace mps {
@@ -22,6 +25,28 @@ typedef function<void(bool)> VerifyFinishCallback;
 class BLSVerifier {
 private:
   Face& m_face;
+  SignerInfoCache m_signerInfoCache;
+  // key locator name -> the fetch of its signature info Data and the packets waiting for it
+  struct PendingFetch
+  {
+    ScopedPendingInterestHandle m_handle;
+    std::vector<std::pair<Data, VerifyFinishCallback>> m_waiters;
+  };
+  std::map<Name, PendingFetch> m_pendingFetches;
+  // batch verification: packets whose signer list passed, waiting for the multi-pairing of their batch
+  struct QueuedVerification
+  {
+    Data m_data;
+    BLSPublicKey m_aggKey;
+    VerifyFinishCallback m_callback;
+  };
+  Scheduler m_scheduler;
+  std::vector<QueuedVerification> m_verificationQueue;
+  scheduler::ScopedEventId m_flushEvent;
+  size_t m_maxBatchSize = 0;
+  time::milliseconds m_maxBatchDelay = time::milliseconds(0);
+  uint64_t m_nVerifiedBatches = 0;
+  VerifierEngine* m_engine = nullptr;
 
 public:
   // known schemas and identities
@@ -37,8 +62,91 @@ public:
   bool
   verify(const Data& data, const Data& signatureInfoData);
 
+  /**
+   * Verify @p data with the signature info Data named by its key locator. The signer list is taken from
+   * the cache, or else fetched, and concurrent calls waiting for the same signature info Data share one fetch.
+   */
   void
   asyncVerify(const Data& data, const VerifyFinishCallback& callback);
+
+  /**
+   * The cache of signer lists decoded from fetched signature info Data, to set its limits or read its counters.
+   */
+  SignerInfoCache&
+  getSignerInfoCache()
+  {
+    return m_signerInfoCache;
+  }
+
+  size_t
+  getNPendingFetches() const
+  {
+    return m_pendingFetches.size();
+  }
+
+  /**
+   * Enable the batch verification of asyncVerify(). Packets are queued for up to @p maxDelay or until
+   * @p maxBatchSize packets are queued, and verified with one randomized multi-pairing per batch.
+   * The packets of a failed batch are bisected, so each callback still gets the result of its own packet.
+   * Zero @p maxBatchSize (the default) verifies each packet right away.
+   */
+  void
+  setBatchVerification(size_t maxBatchSize, time::milliseconds maxDelay)
+  {
+    m_maxBatchSize = maxBatchSize;
+    m_maxBatchDelay = maxDelay;
+  }
+
+  /**
+   * Verify the queued packets now, e.g., before shutting down.
+   */
+  void
+  flushVerificationQueue();
+
+  size_t
+  getNQueuedVerifications() const
+  {
+    return m_verificationQueue.size();
+  }
+
+  uint64_t
+  getNVerifiedBatches() const
+  {
+    return m_nVerifiedBatches;
+  }
+
+  /**
+   * Verify the signatures of asyncVerify() on the worker threads of @p engine, which must outlive this
+   * verifier, or on the I/O thread again with nullptr. The batch verification is not used with an engine.
+   * The schema container is published to the engine here; call again after changing m_schemaContainer.
+   */
+  void
+  setVerifierEngine(VerifierEngine* engine);
+
+private:
+  /**
+   * Check the signer list of @p data against the schema and verify the aggregate signature.
+   */
+  bool
+  verifySignerList(const Data& data, const MpsSignerList& signerList);
+
+  /**
+   * Check the signer list of @p data against the schema and aggregate the public keys into @p aggKey.
+   */
+  bool
+  checkSignerList(const Data& data, const MpsSignerList& signerList, BLSPublicKey& aggKey);
+
+  /**
+   * Verify @p data right away, or queue it for the next batch if the batch verification is enabled.
+   */
+  void
+  verifyOrQueue(const Data& data, const MpsSignerList& signerList, const VerifyFinishCallback& callback);
+
+  /**
+   * Verify the packets waiting for the signature info Data of @p keyLocatorName, with nullptr if the fetch failed.
+   */
+  void
+  onSignerInfoFetched(const Name& keyLocatorName, const Data* signatureInfoData);
 };
 
 }  // namespace mps
@@ -1,5 +1,6 @@
 #include "ndnmps/bls-helpers.hpp"
 #include <ndn-cxx/util/random.hpp>
+#include <algorithm>
 
 namespace ndn {
 namespace mps {
@@ -217,5 +218,148 @@ ndnBLSAggregateSignature(const std::vector<BLSSignature>& signatures)
   return aggSig;
 }
 
+/**
+ * Check the shares in [begin, end) with their randomized sums and bisect when the check fails.
+ */
+static void
+findInvalidSharesInRange(const std::vector<BLSPublicKey>& pubKeys, const std::vector<BLSSignature>& shares,
+                         const std::vector<BLSSecretKey>& scalars, const BLSSignature& hash,
+                         size_t begin, size_t end, std::vector<size_t>& invalidShares)
+{
+  BLSPublicKey aggKey = pubKeys[begin];
+  BLSSignature aggSig = shares[begin];
+  blsPublicKeyMul(&aggKey, &scalars[begin]);
+  blsSignatureMul(&aggSig, &scalars[begin]);
+  for (size_t i = begin + 1; i < end; i++) {
+    BLSPublicKey key = pubKeys[i];
+    BLSSignature sig = shares[i];
+    blsPublicKeyMul(&key, &scalars[i]);
+    blsSignatureMul(&sig, &scalars[i]);
+    blsPublicKeyAdd(&aggKey, &key);
+    blsSignatureAdd(&aggSig, &sig);
+  }
+  // e(aggKey, H(m)) == e(g, aggSig)
+  if (blsVerifyPairing(&aggSig, &hash, &aggKey) == 1) {
+    return;
+  }
+  if (end - begin == 1) {
+    invalidShares.push_back(begin);
+    return;
+  }
+  auto middle = begin + (end - begin) / 2;
+  findInvalidSharesInRange(pubKeys, shares, scalars, hash, begin, middle, invalidShares);
+  findInvalidSharesInRange(pubKeys, shares, scalars, hash, middle, end, invalidShares);
+}
+
+std::vector<size_t>
+ndnBLSFindInvalidShares(const std::vector<BLSPublicKey>& pubKeys, const std::vector<BLSSignature>& shares,
+                        const Data& data)
+{
+  if (pubKeys.size() != shares.size()) {
+    NDN_THROW(std::runtime_error("The number of public keys does not match the number of shares"));
+  }
+  std::vector<size_t> invalidShares;
+  if (shares.empty()) {
+    return invalidShares;
+  }
+  Buffer contiguousBuf;
+  {
+    EncodingBuffer encoder;
+    data.wireEncode(encoder, true);
+    contiguousBuf.assign(encoder.buf(), encoder.buf() + encoder.size());
+  }
+  BLSSignature hash;
+  blsHashToSignature(&hash, contiguousBuf.data(), contiguousBuf.size());
+  std::vector<BLSSecretKey> scalars(shares.size());
+  for (auto& scalar : scalars) {
+    uint64_t randomWord = random::generateSecureWord64() | 1;
+    blsSecretKeySetLittleEndian(&scalar, &randomWord, sizeof(randomWord));
+  }
+  findInvalidSharesInRange(pubKeys, shares, scalars, hash, 0, shares.size(), invalidShares);
+  return invalidShares;
+}
+
+/**
+ * Check the randomized packets in [begin, end) with one multi-pairing and bisect when the check fails.
+ * e(-g, sum(r_i * sig_i)) * prod(e(r_i * pk_i, H(m_i))) == 1
+ */
+static void
+findInvalidSignaturesInRange(const std::vector<BLSPublicKey>& scaledKeys,
+                             const std::vector<BLSSignature>& scaledSignatures,
+                             const std::vector<BLSSignature>& hashes, const std::vector<size_t>& indexes,
+                             size_t begin, size_t end, std::vector<size_t>& invalidSignatures)
+{
+  std::vector<mclBnG1> g1Points;
+  std::vector<mclBnG2> g2Points;
+  BLSSignature aggSig = scaledSignatures[begin];
+  for (size_t i = begin; i < end; i++) {
+    if (i > begin) {
+      blsSignatureAdd(&aggSig, &scaledSignatures[i]);
+    }
+    g1Points.push_back(scaledKeys[i].v);
+    g2Points.push_back(hashes[i].v);
+  }
+  BLSPublicKey generator;
+  blsGetGeneratorOfPublicKey(&generator);
+  mclBnG1 negGenerator;
+  mclBnG1_neg(&negGenerator, &generator.v);
+  g1Points.push_back(negGenerator);
+  g2Points.push_back(aggSig.v);
+  mclBnGT result;
+  mclBn_millerLoopVec(&result, g1Points.data(), g2Points.data(), g1Points.size());
+  mclBn_finalExp(&result, &result);
+  if (mclBnGT_isOne(&result) == 1) {
+    return;
+  }
+  if (end - begin == 1) {
+    invalidSignatures.push_back(indexes[begin]);
+    return;
+  }
+  auto middle = begin + (end - begin) / 2;
+  findInvalidSignaturesInRange(scaledKeys, scaledSignatures, hashes, indexes, begin, middle, invalidSignatures);
+  findInvalidSignaturesInRange(scaledKeys, scaledSignatures, hashes, indexes, middle, end, invalidSignatures);
+}
+
+std::vector<size_t>
+ndnBLSFindInvalidSignatures(const std::vector<BLSPublicKey>& pubKeys, const std::vector<Data>& data)
+{
+  if (pubKeys.size() != data.size()) {
+    NDN_THROW(std::runtime_error("The number of public keys does not match the number of packets"));
+  }
+  std::vector<size_t> invalidSignatures;
+  std::vector<size_t> indexes;
+  std::vector<BLSPublicKey> scaledKeys;
+  std::vector<BLSSignature> scaledSignatures;
+  std::vector<BLSSignature> hashes;
+  for (size_t i = 0; i < data.size(); i++) {
+    const auto& sigValue = data[i].getSignatureValue();
+    BLSSignature sig;
+    if (blsSignatureDeserialize(&sig, sigValue.value(), sigValue.value_size()) == 0) {
+      invalidSignatures.push_back(i);
+      continue;
+    }
+    EncodingBuffer encoder;
+    data[i].wireEncode(encoder, true);
+    BLSSignature hash;
+    blsHashToSignature(&hash, encoder.buf(), encoder.size());
+
+    BLSSecretKey scalar;
+    uint64_t randomWord = random::generateSecureWord64() | 1;
+    blsSecretKeySetLittleEndian(&scalar, &randomWord, sizeof(randomWord));
+    BLSPublicKey key = pubKeys[i];
+    blsPublicKeyMul(&key, &scalar);
+    blsSignatureMul(&sig, &scalar);
+    indexes.push_back(i);
+    scaledKeys.push_back(key);
+    scaledSignatures.push_back(sig);
+    hashes.push_back(hash);
+  }
+  if (!indexes.empty()) {
+    findInvalidSignaturesInRange(scaledKeys, scaledSignatures, hashes, indexes, 0, indexes.size(), invalidSignatures);
+  }
+  std::sort(invalidSignatures.begin(), invalidSignatures.end());
+  return invalidSignatures;
+}
+
 }  // namespace mps
 }  // namespace ndn
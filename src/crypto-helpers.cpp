@@ -28,6 +28,7 @@
 #include <ndn-cxx/security/transform/buffer-source.hpp>
 #include <ndn-cxx/security/transform/stream-sink.hpp>
 #include <ndn-cxx/util/random.hpp>
+#include <openssl/crypto.h>
 #include <openssl/ec.h>
 #include <openssl/err.h>
 #include <openssl/hmac.h>
@@ -37,28 +38,57 @@
 namespace ndn {
 namespace mps {
 
-ECDHState::ECDHState()
+// Curve parameters of prime256v1, generated once and shared by all key generations
+static EVP_PKEY*
+getEcParams()
 {
-  auto EC_NID = NID_X9_62_prime256v1;
-  // params context
-  EVP_PKEY_CTX* ctx_params = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
-  EVP_PKEY_paramgen_init(ctx_params);
-  EVP_PKEY_CTX_set_ec_paramgen_curve_nid(ctx_params, EC_NID);
-  // generate params
-  EVP_PKEY* params = nullptr;
-  EVP_PKEY_paramgen(ctx_params, &params);
-  // key generation context
+  static EVP_PKEY* params = [] {
+    EVP_PKEY* result = nullptr;
+    EVP_PKEY_CTX* ctx_params = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    EVP_PKEY_paramgen_init(ctx_params);
+    EVP_PKEY_CTX_set_ec_paramgen_curve_nid(ctx_params, NID_X9_62_prime256v1);
+    EVP_PKEY_paramgen(ctx_params, &result);
+    EVP_PKEY_CTX_free(ctx_params);
+    return result;
+  }();
+  return params;
+}
+
+// Generate a prime256v1 key pair, return nullptr on failure
+static EVP_PKEY*
+generateEcKey()
+{
+  auto params = getEcParams();
+  if (params == nullptr) {
+    return nullptr;
+  }
+  EVP_PKEY* privkey = nullptr;
   EVP_PKEY_CTX* ctx_keygen = EVP_PKEY_CTX_new(params, nullptr);
   EVP_PKEY_keygen_init(ctx_keygen);
-  auto resultCode = EVP_PKEY_keygen(ctx_keygen, &m_privkey);
+  auto resultCode = EVP_PKEY_keygen(ctx_keygen, &privkey);
   EVP_PKEY_CTX_free(ctx_keygen);
-  EVP_PKEY_free(params);
-  EVP_PKEY_CTX_free(ctx_params);
   if (resultCode <= 0) {
+    return nullptr;
+  }
+  return privkey;
+}
+
+ECDHState::ECDHState()
+  : m_privkey(generateEcKey())
+{
+  if (m_privkey == nullptr) {
     NDN_THROW(std::runtime_error("Error in initiating ECDH"));
   }
 }
 
+ECDHState::ECDHState(EVP_PKEY* privkey)
+  : m_privkey(privkey)
+{
+  if (m_privkey == nullptr) {
+    NDN_THROW(std::runtime_error("Error in initiating ECDH: empty key pair"));
+  }
+}
+
 ECDHState::~ECDHState()
 {
   if (m_privkey != nullptr) {
@@ -123,6 +153,100 @@ ECDHState::deriveSecret(const std::vector<uint8_t>& peerKey)
   return m_secret;
 }
 
+ECDHKeyPool::ECDHKeyPool(size_t capacity, size_t lowWaterMark)
+  : m_capacity(capacity)
+  , m_lowWaterMark(std::min(lowWaterMark, capacity))
+{
+}
+
+ECDHKeyPool::~ECDHKeyPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_shouldStop = true;
+  }
+  m_cv.notify_all();
+  if (m_worker.joinable()) {
+    m_worker.join();
+  }
+  for (auto key : m_keys) {
+    EVP_PKEY_free(key);
+  }
+}
+
+std::shared_ptr<ECDHKeyPool>
+ECDHKeyPool::getShared()
+{
+  static auto pool = [] {
+    // initialize OpenSSL first so that its exit handlers run after the pool is destroyed
+    getEcParams();
+    return std::make_shared<ECDHKeyPool>();
+  }();
+  return pool;
+}
+
+std::unique_ptr<ECDHState>
+ECDHKeyPool::acquire()
+{
+  EVP_PKEY* key = nullptr;
+  if (m_capacity > 0) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_isStarted) {
+      m_isStarted = true;
+      m_worker = std::thread(&ECDHKeyPool::refill, this);
+    }
+    if (!m_keys.empty()) {
+      key = m_keys.front();
+      m_keys.pop_front();
+    }
+    if (m_keys.size() < m_lowWaterMark) {
+      m_cv.notify_one();
+    }
+  }
+  if (key == nullptr) {
+    // the pool is drained or disabled, fall back to synchronous key generation
+    return std::make_unique<ECDHState>();
+  }
+  return std::make_unique<ECDHState>(key);
+}
+
+void
+ECDHKeyPool::setLowWaterMark(size_t lowWaterMark)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lowWaterMark = std::min(lowWaterMark, m_capacity);
+  }
+  m_cv.notify_one();
+}
+
+size_t
+ECDHKeyPool::size() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_keys.size();
+}
+
+void
+ECDHKeyPool::refill()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_shouldStop) {
+    m_cv.wait(lock, [this] { return m_shouldStop || m_keys.size() < m_lowWaterMark; });
+    while (!m_shouldStop && m_keys.size() < m_capacity) {
+      lock.unlock();
+      auto key = generateEcKey();
+      lock.lock();
+      if (key == nullptr) {
+        // back off and retry later instead of spinning on a failing generator
+        m_cv.wait_for(lock, std::chrono::seconds(1));
+        break;
+      }
+      m_keys.push_back(key);
+    }
+  }
+}
+
 void
 hmacSha256(const uint8_t* data, size_t dataLen,
            const uint8_t* key, size_t keyLen,
@@ -135,6 +259,71 @@ hmacSha256(const uint8_t* data, size_t dataLen,
   }
 }
 
+// Compute HMAC-SHA256 over the discontiguous signed ranges of a packet
+static Buffer
+hmacSignedRanges(const std::vector<std::pair<const uint8_t*, size_t>>& signedRanges, const uint8_t* key, size_t keyLen)
+{
+  Buffer contiguousBuf;
+  for (const auto& bufPiece : signedRanges) {
+    contiguousBuf.insert(contiguousBuf.end(), bufPiece.first, bufPiece.first + bufPiece.second);
+  }
+  Buffer result(32);
+  hmacSha256(contiguousBuf.data(), contiguousBuf.size(), key, keyLen, result.data());
+  return result;
+}
+
+void
+signDataWithHmac(Data& data, const uint8_t* key, size_t keyLen, const Name& keyLocatorName)
+{
+  data.setSignatureInfo(SignatureInfo(ndn::tlv::SignatureHmacWithSha256, KeyLocator(keyLocatorName)));
+  EncodingBuffer encoder;
+  data.wireEncode(encoder, true);
+  auto sigValue = std::make_shared<Buffer>(32);
+  hmacSha256(encoder.buf(), encoder.size(), key, keyLen, sigValue->data());
+  data.setSignatureValue(sigValue);
+  data.wireEncode();
+}
+
+bool
+verifyDataWithHmac(const Data& data, const uint8_t* key, size_t keyLen)
+{
+  if (data.getSignatureType() != ndn::tlv::SignatureHmacWithSha256) {
+    return false;
+  }
+  const auto& sigValue = data.getSignatureValue();
+  if (sigValue.value_size() != 32) {
+    return false;
+  }
+  auto expected = hmacSignedRanges(data.extractSignedRanges(), key, keyLen);
+  return CRYPTO_memcmp(expected.data(), sigValue.value(), expected.size()) == 0;
+}
+
+void
+signInterestWithHmac(Interest& interest, const uint8_t* key, size_t keyLen, const Name& keyLocatorName)
+{
+  SignatureInfo sigInfo(ndn::tlv::SignatureHmacWithSha256, KeyLocator(keyLocatorName));
+  sigInfo.setTime(time::system_clock::now());
+  interest.setSignatureInfo(sigInfo);
+  auto sigValue = std::make_shared<Buffer>(hmacSignedRanges(interest.extractSignedRanges(), key, keyLen));
+  interest.setSignatureValue(sigValue);
+  interest.wireEncode();
+}
+
+bool
+verifyInterestWithHmac(const Interest& interest, const uint8_t* key, size_t keyLen)
+{
+  auto sigInfo = interest.getSignatureInfo();
+  if (!sigInfo || sigInfo->getSignatureType() != ndn::tlv::SignatureHmacWithSha256) {
+    return false;
+  }
+  const auto& sigValue = interest.getSignatureValue();
+  if (sigValue.value_size() != 32) {
+    return false;
+  }
+  auto expected = hmacSignedRanges(interest.extractSignedRanges(), key, keyLen);
+  return CRYPTO_memcmp(expected.data(), sigValue.value(), expected.size()) == 0;
+}
+
 size_t
 hkdf(const uint8_t* secret, size_t secretLen, const uint8_t* salt,
      size_t saltLen, uint8_t* output, size_t outputLen,
@@ -5,89 +5,403 @@
 #include <ndn-cxx/util/logger.hpp>
 #include <ndn-cxx/util/random.hpp>
 #include <utility>
-#include <future>
 #include <array>
 #include <iostream>
+#include <set>
 
 namespace ndn {
 namespace mps {
 
 NDN_LOG_INIT(ndnmps.mpsinitiator);
 
+// max number of parameter Interests of a session kept until the ACK is processed
+const size_t MAX_PENDING_PARAMETER_INTERESTS = 8;
+// max number of packets signed in one session, so that a signer's shares fit in one result Data
+const size_t MAX_BATCH_SIZE = 64;
+// room left in a parameter Data for its name, encryption and signature
+const size_t PARAMETER_DATA_OVERHEAD = 512;
+// a parameter Data is served for this long unless the signer has moved on to fetch the result
+const time::milliseconds PARAMETER_LIFETIME = time::seconds(10);
+
 MPSInitiator::MPSInitiator(const Name& prefix, KeyChain& keyChain, Face& face, Scheduler& scheduler)
   : m_prefix(prefix)
     , m_keyChain(keyChain)
     , m_face(face)
     , m_scheduler(scheduler)
     , m_interestSigner(m_keyChain)
-{}
+{
+  // one route for all parameter Data and signature info Data
+  m_mpsPrefixHandle = m_face.setInterestFilter(
+    Name(m_prefix).append("mps"),
+    [this](const auto&, const auto& interest) { onMpsInterest(interest); },
+    nullptr,
+    [](const Name& prefix, const std::string& reason)
+    {
+      NDN_LOG_ERROR("Fail to register prefix " << prefix.toUri() << " because " << reason);
+    });
+}
+
+void
+MPSInitiator::onMpsInterest(const Interest& interest)
+{
+  // /initiator/mps/param/<id>[/digest] or /initiator/mps/<id>
+  const auto& name = interest.getName();
+  removeExpiredParameterHandlers();
+  try {
+    if (name.size() > m_prefix.size() + 2 && name.get(m_prefix.size() + 1) == name::Component("param")) {
+      auto handlerIt = m_parameterHandlers.find(name.get(m_prefix.size() + 2).toNumber());
+      if (handlerIt != m_parameterHandlers.end()) {
+        // the handler may remove itself
+        auto handler = handlerIt->second;
+        handler(interest);
+      }
+    }
+    else {
+      onPublicationInterest(interest);
+    }
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_DEBUG("Bad Interest " << name << ": " << e.what());
+  }
+}
+
+void
+MPSInitiator::addParameterHandler(uint64_t id, const std::function<void(const Interest&)>& handler)
+{
+  removeExpiredParameterHandlers();
+  m_parameterHandlers[id] = handler;
+  m_parameterExpiry.emplace_back(time::steady_clock::now() + PARAMETER_LIFETIME, id);
+}
+
+void
+MPSInitiator::publishInfoData(const Data& infoData)
+{
+  if (m_infoDataLifetime <= time::milliseconds(0)) {
+    return;
+  }
+  m_publications.insert(infoData, m_infoDataLifetime);
+}
+
+void
+MPSInitiator::onPublicationInterest(const Interest& interest)
+{
+  const auto* data = m_publications.find(interest);
+  if (data != nullptr) {
+    m_face.put(*data);
+  }
+}
+
+void
+MPSInitiator::addPublicationPrefix(const Name& prefix)
+{
+  m_publicationPrefixHandles.emplace_back(m_face.setInterestFilter(
+    prefix,
+    [this](const auto&, const auto& interest) { onPublicationInterest(interest); },
+    nullptr,
+    [](const Name& prefix, const std::string& reason)
+    {
+      NDN_LOG_ERROR("Fail to register prefix " << prefix.toUri() << " because " << reason);
+    }));
+}
+
+void
+MPSInitiator::removeExpiredParameterHandlers()
+{
+  // handlers are added with a fixed lifetime, so the queue is in order of expiry
+  auto now = time::steady_clock::now();
+  while (!m_parameterExpiry.empty() && m_parameterExpiry.front().first <= now) {
+    m_parameterHandlers.erase(m_parameterExpiry.front().second);
+    m_parameterExpiry.pop_front();
+  }
+}
 
 struct MultiSignGlobalState
 {
   MpsSignerList m_signers;
   MultipartySchema m_schema;
-  Data m_toBeSigned;
+  // signer key name of a sub-aggregator -> the signers aggregated in its partial aggregates
+  std::map<Name, MpsSignerList> m_subSigners;
+  std::vector<Data> m_toBeSigned; // the packets signed in this session, which share the signer list
   Data m_signInfo;
-  std::vector<Buffer> m_fetchedSignatures;
-  SignatureFinishCallback m_successCb;
+  std::vector<SignatureAggregator> m_aggregators; // one per packet, shares aggregated as they arrive
+  BatchSignatureFinishCallback m_successCb;
+  PartialAggregateCallback m_partialCb; // set when the session only aggregates for a parent initiator
   SignatureFailureCallback m_failureCb;
   Name m_signingKeyName;
+  scheduler::ScopedEventId m_deadlineEvent; // fails the session once it expires
+  bool m_isFinished = false;
+  // the key of the session in the in-flight session table, and the memory it is accounted for
+  uint64_t m_sessionId = 0;
+  size_t m_estimatedSize = 0;
+  // group mode: the parameter Data encrypted once for all signers, and its content key
+  std::array<uint8_t, 16> m_contentKey;
+  Name m_groupParameterName; // full name, including the implicit digest
+  uint64_t m_groupParameterId = 0; // the last name component of the group parameter Data, served until finished
+  // outstanding requests by signer key name, cancelled once the session finishes
+  std::map<Name, PendingInterestHandle> m_pendingInterests;
+  std::map<Name, std::shared_ptr<MultiSignPerSignerState>> m_perSignerStates;
 };
 
 struct MultiSignPerSignerState
 {
   Name m_signerKeyName;
-  ECDHState m_ecdh;
-  std::promise<Data> m_paraDataPromise;
+  std::unique_ptr<ECDHState> m_ecdh;
+  uint64_t m_sessionId = 0; // non-zero when resuming a session
+  std::array<uint8_t, 32> m_nonce;
   std::array<uint8_t, 16> m_aesKey;
-  security::SigningInfo m_hmacSigningInfo;
+  std::array<uint8_t, 32> m_hmacKey;
   Data m_paraData;
+  // the parameter Data is ready once the ACK is processed; Interests arriving earlier wait here
+  bool m_isParaDataReady = false;
+  std::vector<Interest> m_pendingParaInterests;
   Name m_nextResultName;
-  RegisteredPrefixHandle m_paraPrefixHandle;
+  uint64_t m_paraId = 0; // the last name component of the parameter Data
   scheduler::EventId m_resultFetchHandle;
   std::function<void()> m_resultFetchCallback;
+  // a result Interest submitted through the result poller is outstanding
+  bool m_isResultFetchInFlight = false;
+  // adaptive polling
+  time::steady_clock::TimePoint m_ackTime;
+  size_t m_nRetries = 0;
+  // set when this request runs the full handshake that other requests to the signer wait for
+  std::function<void()> m_onHandshakeDone;
 };
 
-std::tuple<Data, Data>
-prepareUnfinishedDataAndInfoData(const Data& unsignedData, const Name& initiatorPrefix)
+/**
+ * @brief Release the requests waiting for the handshake of this request, if any, once.
+ */
+void
+concludeHandshake(MultiSignPerSignerState& perSignerState)
+{
+  if (perSignerState.m_onHandshakeDone) {
+    auto onHandshakeDone = std::move(perSignerState.m_onHandshakeDone);
+    perSignerState.m_onHandshakeDone = nullptr;
+    onHandshakeDone();
+  }
+}
+
+/**
+ * @brief Stop serving and fetching from a signer. The result fetch callback refers to its own state,
+ *        so it is reset to release the state.
+ */
+void
+releasePerSignerState(MultiSignPerSignerState& perSignerState)
+{
+  perSignerState.m_resultFetchHandle.cancel();
+  perSignerState.m_resultFetchCallback = nullptr;
+  concludeHandshake(perSignerState);
+}
+
+/**
+ * @brief Prepare the packets to be signed and the signature info packet they all point to.
+ */
+std::tuple<std::vector<Data>, Data>
+prepareUnfinishedDataAndInfoData(const std::vector<Data>& unsignedData, const Name& initiatorPrefix)
 {
   auto keyLocatorRandomness = random::generateSecureWord64();
   Name keyLocatorName = initiatorPrefix;
   keyLocatorName.append("mps").appendNumber(keyLocatorRandomness);
 
-  Data unfinishedData(unsignedData);
-  unfinishedData.setSignatureInfo(
-    SignatureInfo(static_cast<ndn::tlv::SignatureTypeValue>(tlv::SignatureSha256WithBls),
-                  KeyLocator(keyLocatorName)));
-  unfinishedData.setSignatureValue(make_shared<Buffer>());  // placeholder sig value for wireEncode
+  std::vector<Data> unfinishedData;
+  for (const auto& item : unsignedData) {
+    unfinishedData.push_back(item);
+    unfinishedData.back().setSignatureInfo(
+      SignatureInfo(static_cast<ndn::tlv::SignatureTypeValue>(tlv::SignatureSha256WithBls),
+                    KeyLocator(keyLocatorName)));
+    unfinishedData.back().setSignatureValue(make_shared<Buffer>());  // placeholder sig value for wireEncode
+  }
 
   Data sigInfoData(keyLocatorName);
   return std::make_tuple(unfinishedData, sigInfoData);
 }
 
+/**
+ * @brief Encode the packets to be signed as the parameter: a single Data, or a ParameterBatch of Data.
+ */
+Block
+encodeParameterBatch(const std::vector<Data>& unfinishedData)
+{
+  if (unfinishedData.size() == 1) {
+    return unfinishedData.front().wireEncode();
+  }
+  Block batchBlock(tlv::ParameterBatch);
+  for (const auto& item : unfinishedData) {
+    batchBlock.push_back(item.wireEncode());
+  }
+  batchBlock.encode();
+  return batchBlock;
+}
+
 Data
-prepareParameterData(const Data& unfinishedData, const Name& initiatorPrefix)
+prepareParameterData(const std::vector<Data>& unfinishedData, const Name& initiatorPrefix)
 {
   auto paraRandomness = random::generateSecureWord64();
   Name paraDataName = initiatorPrefix;
   paraDataName.append("mps").append("param").appendNumber(paraRandomness);
   Data paraData;  // /initiator/mps/para/[random]
   paraData.setName(paraDataName);
-  paraData.setContent(unfinishedData.wireEncode());
+  paraData.setContent(encodeParameterBatch(unfinishedData));
   paraData.setFreshnessPeriod(time::seconds(4));
   return paraData;
 }
 
+/**
+ * @brief Collect the signature shares of a result, one per packet of the batch.
+ */
+std::vector<Buffer>
+readSignatureShares(const Block& resultContentBlock)
+{
+  std::vector<Buffer> shares;
+  for (const auto& item : resultContentBlock.elements()) {
+    if (item.type() == tlv::BLSSigValue) {
+      shares.emplace_back(item.value(), item.value_size());
+    }
+  }
+  return shares;
+}
+
+/**
+ * @brief Read the signers aggregated in a result, which is only present in the result of a sub-aggregator.
+ */
+MpsSignerList
+readContributors(const Block& resultContentBlock)
+{
+  auto it = resultContentBlock.find(tlv::MpsSignerList);
+  if (it == resultContentBlock.elements_end()) {
+    return MpsSignerList();
+  }
+  return MpsSignerList(*it);
+}
+
+/**
+ * @brief Read the time from the ACK until the result was ready, as reported by the signer.
+ *        @p measured is used for a signer that does not report it.
+ */
+time::milliseconds
+readServiceTime(const Block& resultContentBlock, time::milliseconds measured)
+{
+  auto it = resultContentBlock.find(tlv::ServiceTime);
+  if (it == resultContentBlock.elements_end()) {
+    return measured;
+  }
+  return time::milliseconds(readNonNegativeInteger(*it));
+}
+
+/**
+ * @brief The keys to check the shares of a session with. The partial aggregate of a sub-aggregator is checked
+ *        with the aggregate key of the signers it lists, and is invalid if one of them is not trusted.
+ */
+std::map<Name, BLSPublicKey>
+getShareKeys(const std::map<Name, BLSPublicKey>& trustedKeys, const std::map<Name, MpsSignerList>& subSigners)
+{
+  auto shareKeys = trustedKeys;
+  for (const auto& item : subSigners) {
+    std::vector<BLSPublicKey> pubKeys;
+    for (const auto& signer : item.second.m_signers) {
+      auto keyIt = trustedKeys.find(signer);
+      if (keyIt == trustedKeys.end()) {
+        break;
+      }
+      pubKeys.push_back(keyIt->second);
+    }
+    if (pubKeys.size() == item.second.m_signers.size()) {
+      shareKeys[item.first] = ndnBLSAggregatePublicKey(pubKeys);
+    }
+    else {
+      shareKeys.erase(item.first);
+    }
+  }
+  return shareKeys;
+}
+
+/**
+ * @brief Prepare the per-signer parameter Data of group mode, which only carries the content key.
+ */
+Data
+prepareContentKeyParameterData(const std::array<uint8_t, 16>& contentKey, const Name& initiatorPrefix)
+{
+  Name paraDataName = initiatorPrefix;
+  paraDataName.append("mps").append("param").appendNumber(random::generateSecureWord64());
+  Data paraData(paraDataName);
+  paraData.setContent(makeBinaryBlock(tlv::GroupContentKey, contentKey.data(), contentKey.size()));
+  paraData.setFreshnessPeriod(time::seconds(4));
+  return paraData;
+}
+
+/**
+ * @brief Set the AES key and HMAC key of the request from 48 bytes of derived key material.
+ */
+void
+setRequestKeys(const uint8_t* aesAndHmac, std::shared_ptr<MultiSignPerSignerState> perSignerState)
+{
+  std::memcpy(perSignerState->m_aesKey.data(), aesAndHmac, 16);
+  std::memcpy(perSignerState->m_hmacKey.data(), aesAndHmac + 16, 32);
+}
+
 Interest
-prepareSignRequestInterest(const Name& signerPrefix, const Name& paraDataName, const std::vector<uint8_t>& selfPubKey)
+prepareSignRequestInterest(const Name& signerKeyName, const Name& paraDataName, const std::vector<uint8_t>& selfPubKey,
+                           uint64_t sessionId = 0, const uint8_t* nonce = nullptr,
+                           const Name& groupParameterName = Name())
 {
   Interest signRequestInt;
-  auto signRequestName = signerPrefix;
+  auto signRequestName = signerKeyName.getPrefix(-2);
   signRequestName.append("mps").append("sign");
   signRequestInt.setName(signRequestName);
   Block appParam(ndn::tlv::ApplicationParameters);
+  appParam.push_back(makeNestedBlock(tlv::SignerKeyName, signerKeyName));
   appParam.push_back(makeNestedBlock(tlv::ParameterDataName, paraDataName));
+  if (!groupParameterName.empty()) {
+    appParam.push_back(makeNestedBlock(tlv::GroupParameterName, groupParameterName));
+  }
+  if (sessionId != 0) {
+    appParam.push_back(makeNonNegativeIntegerBlock(tlv::SessionId, sessionId));
+    appParam.push_back(makeBinaryBlock(tlv::Salt, nonce, 32));
+  }
+  else {
+    appParam.push_back(makeBinaryBlock(tlv::EcdhPub, selfPubKey.data(), selfPubKey.size()));
+  }
+  appParam.encode();
+  signRequestInt.setApplicationParameters(appParam);
+  signRequestInt.setCanBePrefix(false);
+  signRequestInt.setMustBeFresh(true);
+  return signRequestInt;
+}
+
+/**
+ * @brief Read the RetryAfter hint of an Unavailable reply, one second if absent.
+ */
+time::milliseconds
+readRetryAfter(const Data& reply)
+{
+  try {
+    const auto& contentBlock = reply.getContent();
+    contentBlock.parse();
+    return time::milliseconds(readNonNegativeInteger(contentBlock.get(tlv::RetryAfter)));
+  }
+  catch (const std::exception&) {
+    return time::seconds(1);
+  }
+}
+
+/**
+ * @brief Prepare the one-round-trip sign request, which carries the unsigned Data encrypted with
+ *        the key derived from the signer's static ECDH key.
+ */
+Interest
+prepareInlineSignRequestInterest(const Name& signerKeyName, const std::vector<uint8_t>& selfPubKey,
+                                 const uint8_t* salt, const uint8_t* aesKey,
+                                 const uint8_t* unfinishedData, size_t unfinishedDataSize)
+{
+  Interest signRequestInt;
+  auto signRequestName = signerKeyName.getPrefix(-2);
+  signRequestName.append("mps").append("sign");
+  signRequestInt.setName(signRequestName);
+  Block appParam(ndn::tlv::ApplicationParameters);
+  appParam.push_back(makeNestedBlock(tlv::SignerKeyName, signerKeyName));
   appParam.push_back(makeBinaryBlock(tlv::EcdhPub, selfPubKey.data(), selfPubKey.size()));
+  appParam.push_back(makeBinaryBlock(tlv::Salt, salt, 32));
+  appParam.push_back(encodeBlockWithAesGcm128(tlv::InlineParameter, aesKey,
+                                              unfinishedData, unfinishedDataSize, nullptr, 0));
   appParam.encode();
   signRequestInt.setApplicationParameters(appParam);
   signRequestInt.setCanBePrefix(false);
@@ -95,8 +409,15 @@ prepareSignRequestInterest(const Name& signerPrefix, const Name& paraDataName, c
   return signRequestInt;
 }
 
+/**
+ * @brief Parse the ACK of a sign request.
+ *
+ * For a full handshake, derive the request keys with ECDH. If the signer offers a resumable session,
+ * @p offeredSession is filled with a non-zero session ID, the session secret and the expiry.
+ */
 void
 parseAckReply(const Data& data, std::string& ackCode, time::milliseconds& result_ms, Name& resultName,
+              ResumableSession& offeredSession,
               std::shared_ptr<MultiSignPerSignerState> perSignerState)
 {
   std::vector<uint8_t> peerPub;
@@ -104,27 +425,24 @@ parseAckReply(const Data& data, std::string& ackCode, time::milliseconds& result
   auto contentBlock = data.getContent();
   contentBlock.parse();
   ackCode = readString(contentBlock.get(tlv::Status));
-  if (ackCode == "102") {
+  if (ackCode != "102") {
+    NDN_THROW(std::runtime_error("Rejected by the signer with Error code" + ackCode));
+  }
+  // AES key, HMAC key and the session secret
+  std::array<uint8_t, 80> keyMaterial;
+  if (perSignerState->m_sessionId == 0) {
     const auto& ecdhBlock = contentBlock.get(tlv::EcdhPub);
     peerPub.resize(ecdhBlock.value_size());
     std::memcpy(peerPub.data(), ecdhBlock.value(), ecdhBlock.value_size());
 
     const auto& saltBlock = contentBlock.get(tlv::Salt);
     std::memcpy(salt.data(), saltBlock.value(), saltBlock.value_size());
+
+    // ECDH and generate HMAC KEY and AES KEY
+    auto dhSecret = perSignerState->m_ecdh->deriveSecret(peerPub);
+    hkdf(dhSecret.data(), dhSecret.size(), salt.data(), salt.size(), keyMaterial.data(), keyMaterial.size());
+    setRequestKeys(keyMaterial.data(), perSignerState);
   }
-  else {
-    NDN_THROW(std::runtime_error("Rejected by the signer with Error code" + ackCode));
-  }
-  // ECDH and generate HMAC KEY and AES KEY
-  auto dhSecret = perSignerState->m_ecdh.deriveSecret(peerPub);
-  std::array<uint8_t, 48> aesAndHmac;
-  hkdf(dhSecret.data(), dhSecret.size(), salt.data(), salt.size(), aesAndHmac.data(), aesAndHmac.size());
-  std::memcpy(perSignerState->m_aesKey.data(), aesAndHmac.data(), 16);
-  auto hmacKeyStr = base64EncodeFromBytes(aesAndHmac.data() + 16, 32, false);
-  // HMAC
-  perSignerState->m_hmacSigningInfo.setSigningHmacKey(hmacKeyStr);
-  perSignerState->m_hmacSigningInfo.setDigestAlgorithm(DigestAlgorithm::SHA256);
-  perSignerState->m_hmacSigningInfo.setSignedInterestFormat(security::SignedInterestFormat::V03);
   // Decrypt
   Block decrypteBlock(ndn::tlv::Content,
                       std::make_shared<Buffer>(decodeBlockWithAesGcm128(contentBlock,
@@ -134,6 +452,13 @@ parseAckReply(const Data& data, std::string& ackCode, time::milliseconds& result
   result_ms = time::milliseconds(readNonNegativeInteger(decrypteBlock.get(tlv::ResultAfter)));
   resultName.wireDecode(decrypteBlock.get(tlv::ResultName).blockFromValue());
   std::cout << "result name: " << resultName.toUri() << std::endl;
+  auto sessionIdIt = decrypteBlock.find(tlv::SessionId);
+  if (perSignerState->m_sessionId == 0 && sessionIdIt != decrypteBlock.elements_end()) {
+    offeredSession.m_id = readNonNegativeInteger(*sessionIdIt);
+    std::memcpy(offeredSession.m_secret.data(), keyMaterial.data() + 48, offeredSession.m_secret.size());
+    offeredSession.m_expiry = time::steady_clock::now() +
+      time::milliseconds(readNonNegativeInteger(decrypteBlock.get(tlv::SessionLifetime)));
+  }
 }
 
 Block
@@ -148,38 +473,91 @@ parseResultData(const Data& data, std::shared_ptr<MultiSignPerSignerState> perSi
 }
 
 void
-MPSInitiator::performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlobalState> globalState)
+MPSInitiator::performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlobalState> globalState,
+                         bool canWaitForHandshake)
 {
+  const ResumableSession* session = nullptr;
+  if (m_sessionCache.isEnabled()) {
+    session = m_sessionCache.findByPeer(signerKeyName);
+  }
   auto perSignerState = std::make_shared<MultiSignPerSignerState>();
   perSignerState->m_signerKeyName = signerKeyName;
-  // prepare un-encrypted parameter data
-  perSignerState->m_paraData = prepareParameterData(globalState->m_toBeSigned, m_prefix);
-  // prepare a future for finalized parameter data
-  std::shared_future<Data> paraDataFuture(perSignerState->m_paraDataPromise.get_future());
-  // register prefix to answer future parameter data
-  perSignerState->m_paraPrefixHandle = m_face.setInterestFilter(
-    perSignerState->m_paraData.getName(),
-    [paraDataFuture, this](const auto&,
-                           const auto& interest) mutable
+  if (session == nullptr && m_sessionCache.isEnabled() && canWaitForHandshake) {
+    auto handshakeIt = m_pendingHandshakes.find(signerKeyName);
+    if (handshakeIt != m_pendingHandshakes.end()) {
+      // coalesce with the handshake in progress and resume the session it establishes
+      handshakeIt->second.push_back([=] {
+        if (!globalState->m_isFinished) {
+          performRPC(signerKeyName, globalState, false);
+        }
+      });
+      return;
+    }
+    m_pendingHandshakes[signerKeyName];
+    perSignerState->m_onHandshakeDone = [this, signerKeyName] {
+      auto handshakeIt = m_pendingHandshakes.find(signerKeyName);
+      if (handshakeIt == m_pendingHandshakes.end()) {
+        return;
+      }
+      auto waitingRequests = std::move(handshakeIt->second);
+      m_pendingHandshakes.erase(handshakeIt);
+      for (const auto& resume : waitingRequests) {
+        resume();
+      }
+    };
+  }
+  globalState->m_perSignerStates[signerKeyName] = perSignerState;
+  if (session != nullptr) {
+    // resume the session: derive the request keys from the session secret and a fresh nonce
+    perSignerState->m_sessionId = session->m_id;
+    random::generateSecureBytes(perSignerState->m_nonce.data(), perSignerState->m_nonce.size());
+    std::array<uint8_t, 48> aesAndHmac;
+    hkdf(session->m_secret.data(), session->m_secret.size(),
+         perSignerState->m_nonce.data(), perSignerState->m_nonce.size(),
+         aesAndHmac.data(), aesAndHmac.size());
+    setRequestKeys(aesAndHmac.data(), perSignerState);
+  }
+  else {
+    perSignerState->m_ecdh = m_ecdhKeyPool->acquire();
+  }
+  // prepare un-encrypted parameter data, only the content key in group mode
+  if (globalState->m_groupParameterName.empty()) {
+    perSignerState->m_paraData = prepareParameterData(globalState->m_toBeSigned, m_prefix);
+  }
+  else {
+    perSignerState->m_paraData = prepareContentKeyParameterData(globalState->m_contentKey, m_prefix);
+  }
+  // answer parameter data through the dispatcher, never blocking the face's thread
+  std::weak_ptr<MultiSignPerSignerState> weakState = perSignerState;
+  perSignerState->m_paraId = perSignerState->m_paraData.getName().get(-1).toNumber();
+  addParameterHandler(
+    perSignerState->m_paraId,
+    [weakState, this](const Interest& interest)
     {
       std::cout << "\n\nInitiator: Receive Interest for parameter Data from signer." << std::endl;
-      paraDataFuture.wait();
-      m_face.put(paraDataFuture.get());
-    },
-    nullptr,
-    [](const Name& prefix, const std::string& reason)
-    {
-      NDN_LOG_ERROR("Fail to register prefix " << prefix.toUri() << " because " << reason);
+      auto perSignerState = weakState.lock();
+      if (perSignerState == nullptr) {
+        return;
+      }
+      if (perSignerState->m_isParaDataReady) {
+        m_face.put(perSignerState->m_paraData);
+      }
+      else if (perSignerState->m_pendingParaInterests.size() < MAX_PENDING_PARAMETER_INTERESTS) {
+        perSignerState->m_pendingParaInterests.push_back(interest);
+      }
     });
-  // TODO: schedule an event for failure callback
 
   // send sign request Interest: /signer/mps/sign/hash
-  auto signRequestInt = prepareSignRequestInterest(signerKeyName.getPrefix(-2),
+  auto signRequestInt = prepareSignRequestInterest(signerKeyName,
                                                    perSignerState->m_paraData.getName(),
-                                                   perSignerState->m_ecdh.getSelfPubKey());
+                                                   session == nullptr ? perSignerState->m_ecdh->getSelfPubKey()
+                                                                      : std::vector<uint8_t>(),
+                                                   perSignerState->m_sessionId,
+                                                   perSignerState->m_nonce.data(),
+                                                   globalState->m_groupParameterName);
   m_interestSigner.makeSignedInterest(signRequestInt, signingByKey(globalState->m_signingKeyName));
   std::cout << "\n\nInitiator: Send MPS Sign Interest to signer: " << signerKeyName.getPrefix(-2).toUri() << std::endl;
-  m_face.expressInterest(
+  globalState->m_pendingInterests[signerKeyName] = m_face.expressInterest(
     signRequestInt,
     [=](const auto&, const auto& ackData)
     {
@@ -190,14 +568,40 @@ MPSInitiator::performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlo
       // parse ack content
       std::string ackCode;
       time::milliseconds result_ms;
+      ResumableSession offeredSession;
       try {
-        parseAckReply(ackData, ackCode, result_ms, perSignerState->m_nextResultName, perSignerState);
+        parseAckReply(ackData, ackCode, result_ms, perSignerState->m_nextResultName, offeredSession, perSignerState);
       }
       catch (const std::exception& e) {
         // should abort and change to another signer
         std::cout << e.what() << std::endl;
+        concludeHandshake(*perSignerState);
+        if (perSignerState->m_sessionId != 0 && ackCode == "404") {
+          // the signer no longer knows the session, fall back to a full handshake
+          m_sessionCache.erase(perSignerState->m_sessionId);
+          m_parameterHandlers.erase(perSignerState->m_paraId);
+          performRPC(perSignerState->m_signerKeyName, globalState);
+        }
+        else if (ackCode == "503") {
+          m_parameterHandlers.erase(perSignerState->m_paraId);
+          onOverloadedSigner(perSignerState->m_signerKeyName, readRetryAfter(ackData), globalState);
+        }
+        else {
+          m_parameterHandlers.erase(perSignerState->m_paraId);
+          onUnavailableSigner("Rejected by signer " + perSignerState->m_signerKeyName.getPrefix(-2).toUri() +
+                              " with Error code " + ackCode,
+                              perSignerState->m_signerKeyName, globalState);
+        }
         return;
       }
+      if (offeredSession.m_id != 0 && m_sessionCache.isEnabled()) {
+        offeredSession.m_peer = perSignerState->m_signerKeyName;
+        offeredSession.m_expiry = std::min(offeredSession.m_expiry,
+                                           time::steady_clock::now() + m_sessionCache.getLifetime());
+        m_sessionCache.insert(offeredSession);
+      }
+      // the requests waiting for this handshake resume the session, or run their own handshakes if none is offered
+      concludeHandshake(*perSignerState);
       // update paraData to be ready to be fetched
       const auto& unencryptedBlock = perSignerState->m_paraData.getContent();
       auto encryptedBlock = encodeBlockWithAesGcm128(ndn::tlv::Content,
@@ -206,62 +610,63 @@ MPSInitiator::performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlo
                                                      unencryptedBlock.value_size(),
                                                      nullptr, 0);
       perSignerState->m_paraData.setContent(encryptedBlock);
-      m_keyChain.sign(perSignerState->m_paraData, perSignerState->m_hmacSigningInfo);
-      perSignerState->m_paraDataPromise.set_value(perSignerState->m_paraData);
-      std::cout << "Initiator: Register prefix for parameter data: "
+      signDataWithHmac(perSignerState->m_paraData,
+                       perSignerState->m_hmacKey.data(), perSignerState->m_hmacKey.size(),
+                       perSignerState->m_nextResultName.getPrefix(-1));
+      perSignerState->m_isParaDataReady = true;
+      if (!perSignerState->m_pendingParaInterests.empty()) {
+        // one Data satisfies all the pending Interests
+        m_face.put(perSignerState->m_paraData);
+        perSignerState->m_pendingParaInterests.clear();
+      }
+      std::cout << "Initiator: Parameter data is ready: "
                 << perSignerState->m_paraData.getName().toUri() << std::endl;
 
       // set the scheduler to fetch the result
+      perSignerState->m_ackTime = time::steady_clock::now();
       perSignerState->m_resultFetchCallback = [=]()
       {
+        auto stateIt = globalState->m_perSignerStates.find(perSignerState->m_signerKeyName);
+        if (globalState->m_isFinished || stateIt == globalState->m_perSignerStates.end() ||
+            stateIt->second != perSignerState) {
+          // the session finished or the signer was released while the fetch was queued
+          m_resultPoller.onFetchDone();
+          return;
+        }
         std::cout << "\n\nInitiator: Send Interest for result Data from signer: "
                   << perSignerState->m_nextResultName.getPrefix(-3).toUri() << std::endl;
-        perSignerState->m_paraPrefixHandle.cancel();
+        m_parameterHandlers.erase(perSignerState->m_paraId);
         Interest resultFetchInt(perSignerState->m_nextResultName);
         resultFetchInt.setCanBePrefix(true);
         resultFetchInt.setMustBeFresh(true);
-        m_interestSigner.makeSignedInterest(resultFetchInt, signingByKey(globalState->m_signingKeyName));
-        m_face.expressInterest(
+        signInterestWithHmac(resultFetchInt,
+                             perSignerState->m_hmacKey.data(), perSignerState->m_hmacKey.size(),
+                             perSignerState->m_nextResultName.getPrefix(-1));
+        perSignerState->m_isResultFetchInFlight = true;
+        globalState->m_pendingInterests[perSignerState->m_signerKeyName] = m_face.expressInterest(
           resultFetchInt,
           [=](const auto&, const auto& resultData)
           {
+            concludeResultFetch(*perSignerState);
             auto signerPrefix = resultData.getName().getPrefix(-5);
 
             std::cout << "\n\nInitiator: Fetched result Data from signer: "
                       << signerPrefix.toUri() << std::endl << resultData;
-            if (!security::verifySignature(resultData, m_keyChain.getTpm(),
-                                           perSignerState->m_hmacSigningInfo.getSignerName(),
-                                           DigestAlgorithm::SHA256)) {
+            if (!verifyDataWithHmac(resultData,
+                                    perSignerState->m_hmacKey.data(), perSignerState->m_hmacKey.size())) {
               std::cout << "Initiator: HMAC verification failed" << std::endl;
               return;
             }
             auto resultContentBlock = parseResultData(resultData, perSignerState);
             auto code = readString(resultContentBlock.get(tlv::Status));
             if (code == "200") {
-              auto sigBlock = resultContentBlock.get(tlv::BLSSigValue);
-              globalState->m_fetchedSignatures.emplace_back(Buffer(sigBlock.value(), sigBlock.value_size()));
-              if (globalState->m_fetchedSignatures.size() ==
-                  globalState->m_signers.m_signers.size()) {
-                // all signatures have been fetched
-                auto begin = std::chrono::steady_clock::now();
-                auto aggSignature = std::make_shared<Buffer>(
-                  ndnBLSAggregateSignature(globalState->m_fetchedSignatures));
-                auto end = std::chrono::steady_clock::now();
-                std::cout << "Initiator aggregating signature pieces of size" << globalState->m_fetchedSignatures.size()
-                          << ": "
-                          << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
-                          << "[µs]" << std::endl;
-                globalState->m_toBeSigned.setSignatureValue(aggSignature);
-                globalState->m_toBeSigned.wireEncode();
-
-                // prepare the signature info packet
-                globalState->m_signInfo.setContent(globalState->m_signers.wireEncode());
-                m_keyChain.sign(globalState->m_signInfo, signingByKey(globalState->m_signingKeyName));
-                std::cout << "Initiator: info packet is ready" << std::endl;
-
-                // end the multiparty signature
-                globalState->m_successCb(globalState->m_toBeSigned, globalState->m_signInfo);
-              }
+              // the signer's own figure is not bounded below by the delay of this fetch
+              auto measured = time::duration_cast<time::milliseconds>(time::steady_clock::now() -
+                                                                      perSignerState->m_ackTime);
+              m_resultPoller.recordServiceTime(perSignerState->m_signerKeyName,
+                                               readServiceTime(resultContentBlock, measured));
+              onSignatureShare(perSignerState->m_signerKeyName, readSignatureShares(resultContentBlock),
+                               readContributors(resultContentBlock), globalState);
             }
             else if (code != "102") {
               onUnavailableSigner("Received Error code when requesting signer " + perSignerState->m_signerKeyName.getPrefix(-2).toUri(),
@@ -270,26 +675,29 @@ MPSInitiator::performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlo
             else {
               // processing
               auto result_ms = time::milliseconds(readNonNegativeInteger(resultContentBlock.get(tlv::ResultAfter)));
-              Name newResultName(resultContentBlock.get(tlv::ResultName).blockFromValue());
-              perSignerState->m_resultFetchHandle = m_scheduler.schedule(result_ms,
-                                                                         perSignerState->m_resultFetchCallback);
+              perSignerState->m_nextResultName = Name(resultContentBlock.get(tlv::ResultName).blockFromValue());
+              scheduleResultFetch(m_resultPoller.getRetryDelay(perSignerState->m_nRetries++, result_ms),
+                                  perSignerState, globalState);
             }
           },
           [=](const Interest& interest, const lp::Nack& nack)
           {
+            concludeResultFetch(*perSignerState);
             NDN_LOG_ERROR("Received NACK with reason " << nack.getReason() << " for " << interest.getName());
             onUnavailableSigner("Received NACK when requesting signer " + perSignerState->m_signerKeyName.getPrefix(-2).toUri(),
                                 perSignerState->m_signerKeyName, globalState);
           },
           [=](const Interest& interest)
           {
+            concludeResultFetch(*perSignerState);
             NDN_LOG_ERROR("interest time out for " << interest.getName());
             onUnavailableSigner("Interest timeout when requesting signer " + perSignerState->m_signerKeyName.getPrefix(-2).toUri(),
                                 perSignerState->m_signerKeyName, globalState);
           }
         );
       };
-      perSignerState->m_resultFetchHandle = m_scheduler.schedule(result_ms, perSignerState->m_resultFetchCallback);
+      scheduleResultFetch(m_resultPoller.getFirstDelay(perSignerState->m_signerKeyName, result_ms),
+                          perSignerState, globalState);
     },
     [=](const Interest& interest, const lp::Nack& nack)
     {
@@ -306,48 +714,555 @@ MPSInitiator::performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlo
   );
 }
 
+void
+MPSInitiator::markSessionFinished(std::shared_ptr<MultiSignGlobalState> globalState)
+{
+  globalState->m_isFinished = true;
+  globalState->m_deadlineEvent.cancel();
+  for (auto& item : globalState->m_pendingInterests) {
+    item.second.cancel();
+  }
+  globalState->m_pendingInterests.clear();
+  if (globalState->m_groupParameterId != 0) {
+    m_parameterHandlers.erase(globalState->m_groupParameterId);
+  }
+  for (auto& item : globalState->m_perSignerStates) {
+    // the cancelled result Interests run no callback, so their poller slots are released here
+    concludeResultFetch(*item.second);
+    releasePerSignerState(*item.second);
+  }
+  globalState->m_perSignerStates.clear();
+  if (m_sessions.erase(globalState->m_sessionId) > 0) {
+    m_liveSessionBytes -= globalState->m_estimatedSize;
+  }
+}
+
+void
+MPSInitiator::concludeResultFetch(MultiSignPerSignerState& perSignerState)
+{
+  if (perSignerState.m_isResultFetchInFlight) {
+    perSignerState.m_isResultFetchInFlight = false;
+    m_resultPoller.onFetchDone();
+  }
+}
+
+void
+MPSInitiator::scheduleResultFetch(time::milliseconds delay,
+                                  std::shared_ptr<MultiSignPerSignerState> perSignerState,
+                                  std::shared_ptr<MultiSignGlobalState> globalState)
+{
+  if (globalState->m_isFinished) {
+    return;
+  }
+  perSignerState->m_resultFetchHandle = m_scheduler.schedule(delay, [=] {
+    if (!globalState->m_isFinished) {
+      m_resultPoller.submit(perSignerState->m_resultFetchCallback);
+    }
+  });
+}
+
+void
+MPSInitiator::onSignatureShare(const Name& signerKeyName, const std::vector<Buffer>& shares,
+                               const MpsSignerList& contributors,
+                               std::shared_ptr<MultiSignGlobalState> globalState)
+{
+  if (globalState->m_isFinished) {
+    return;
+  }
+  // the signers listed by a sub-aggregator can only be checked with their trusted keys
+  for (const auto& contributor : contributors.m_signers) {
+    if (m_schemaContainer.m_trustedIds.count(contributor) == 0) {
+      onUnavailableSigner("Untrusted signer " + contributor.toUri() + " in the partial aggregate of " +
+                          signerKeyName.getPrefix(-2).toUri(),
+                          signerKeyName, globalState);
+      return;
+    }
+  }
+  bool isValid = shares.size() == globalState->m_toBeSigned.size();
+  for (size_t i = 0; isValid && i < shares.size(); i++) {
+    isValid = globalState->m_aggregators[i].add(signerKeyName, shares[i]);
+  }
+  if (!isValid) {
+    onUnavailableSigner("Bad signature share from signer " + signerKeyName.getPrefix(-2).toUri(),
+                        signerKeyName, globalState);
+    return;
+  }
+  if (!contributors.m_signers.empty()) {
+    globalState->m_subSigners[signerKeyName] = contributors;
+  }
+  tryFinishSession(globalState);
+}
+
+void
+MPSInitiator::tryFinishSession(std::shared_ptr<MultiSignGlobalState> globalState)
+{
+  auto begin = std::chrono::steady_clock::now();
+  // every signer contributes to all packets, so the aggregators have the same signers
+  auto contributors = globalState->m_aggregators.front().getSigners();
+  if (globalState->m_schema.passSchema(contributors)) {
+    // enough signatures have been fetched, the ones still outstanding (e.g., hedged) are not needed
+    // a partial aggregate stands for the signers it lists, which must not be counted twice
+    std::set<Name> invalidSigners;
+    MpsSignerList signers;
+    for (const auto& contributor : contributors) {
+      auto subSignersIt = globalState->m_subSigners.find(contributor);
+      bool isMerged = subSignersIt == globalState->m_subSigners.end() ?
+                        signers.merge(MpsSignerList(std::vector<Name>{contributor})) :
+                        signers.merge(subSignersIt->second);
+      if (!isMerged) {
+        invalidSigners.insert(contributor);
+      }
+    }
+    // a partial aggregate is always checked, as nothing else backs the signers it lists
+    if (m_isShareVerificationEnabled || !globalState->m_subSigners.empty()) {
+      const auto* trustedKeys = &m_schemaContainer.m_trustedIds;
+      std::map<Name, BLSPublicKey> shareKeys;
+      if (!globalState->m_subSigners.empty()) {
+        shareKeys = getShareKeys(m_schemaContainer.m_trustedIds, globalState->m_subSigners);
+        trustedKeys = &shareKeys;
+      }
+      for (size_t i = 0; i < globalState->m_toBeSigned.size(); i++) {
+        auto invalidSharesOfPacket = globalState->m_aggregators[i].findInvalidShares(*trustedKeys,
+                                                                                     globalState->m_toBeSigned[i]);
+        invalidSigners.insert(invalidSharesOfPacket.begin(), invalidSharesOfPacket.end());
+      }
+    }
+    if (!invalidSigners.empty()) {
+      for (const auto& signer : invalidSigners) {
+        onUnavailableSigner("Invalid signature share from signer " + signer.getPrefix(-2).toUri(),
+                            signer, globalState);
+        if (globalState->m_isFinished) {
+          return;
+        }
+      }
+      // the remaining shares may still pass the schema
+      tryFinishSession(globalState);
+      return;
+    }
+    // the signer list published by the root names the signers in the partial aggregates, so it must pass
+    // the schema a verifier applies to the packets, besides the session schema naming the sub-aggregators
+    if (!globalState->m_subSigners.empty() && !globalState->m_partialCb) {
+      for (const auto& data : globalState->m_toBeSigned) {
+        if (!m_schemaContainer.passSchema(data.getName(), signers)) {
+          markSessionFinished(globalState);
+          globalState->m_failureCb("The signers in the partial aggregates do not pass the schema of " +
+                                   data.getName().toUri());
+          return;
+        }
+      }
+    }
+    globalState->m_signers = signers;
+    if (globalState->m_partialCb) {
+      std::vector<Buffer> aggregates;
+      for (const auto& aggregator : globalState->m_aggregators) {
+        aggregates.push_back(aggregator.getSignature());
+      }
+      markSessionFinished(globalState);
+      globalState->m_partialCb(aggregates, globalState->m_signers);
+      return;
+    }
+    for (size_t i = 0; i < globalState->m_toBeSigned.size(); i++) {
+      auto aggSignature = std::make_shared<Buffer>(globalState->m_aggregators[i].getSignature());
+      globalState->m_toBeSigned[i].setSignatureValue(aggSignature);
+      globalState->m_toBeSigned[i].wireEncode();
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "Initiator aggregating signature pieces of size" << contributors.size()
+              << " for " << globalState->m_toBeSigned.size() << " packets: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
+              << "[µs]" << std::endl;
+
+    // prepare the signature info packet
+    globalState->m_signInfo.setContent(globalState->m_signers.wireEncode());
+    m_keyChain.sign(globalState->m_signInfo, signingByKey(globalState->m_signingKeyName));
+    publishInfoData(globalState->m_signInfo);
+    if (m_isSignedDataPublished && m_infoDataLifetime > time::milliseconds(0)) {
+      for (const auto& data : globalState->m_toBeSigned) {
+        m_publications.insert(data, m_infoDataLifetime);
+      }
+    }
+    std::cout << "Initiator: info packet is ready" << std::endl;
+
+    // end the multiparty signature
+    markSessionFinished(globalState);
+    globalState->m_successCb(globalState->m_toBeSigned, globalState->m_signInfo);
+  }
+}
+
+void
+MPSInitiator::requestSignature(const Name& signerKeyName, std::shared_ptr<MultiSignGlobalState> globalState)
+{
+  if (m_inlineParameterLimit > 0 && globalState->m_toBeSigned.size() == 1 &&
+      globalState->m_toBeSigned.front().wireEncode().size() <= m_inlineParameterLimit) {
+    performInlineRPC(signerKeyName, globalState);
+  }
+  else {
+    performRPC(signerKeyName, globalState);
+  }
+}
+
+void
+MPSInitiator::fetchSignerStaticKey(const Name& signerKeyName, const function<void(bool)>& callback)
+{
+  // concurrent sessions wait for the same fetch
+  auto& waiters = m_pendingStaticKeyFetches[signerKeyName];
+  waiters.push_back(callback);
+  if (waiters.size() > 1) {
+    return;
+  }
+  auto onFetched = [this, signerKeyName] (bool isFetched) {
+    auto it = m_pendingStaticKeyFetches.find(signerKeyName);
+    if (it == m_pendingStaticKeyFetches.end()) {
+      return;
+    }
+    auto waiters = std::move(it->second);
+    m_pendingStaticKeyFetches.erase(it);
+    for (const auto& waiter : waiters) {
+      waiter(isFetched);
+    }
+  };
+  Interest keyInterest(Name(signerKeyName.getPrefix(-2)).append("mps").append("ecdh"));
+  keyInterest.setCanBePrefix(true);
+  keyInterest.setMustBeFresh(true);
+  m_face.expressInterest(
+    keyInterest,
+    [=](const auto&, const auto& keyData)
+    {
+      // the static ECDH key must be signed by the trusted BLS key of the signer
+      auto trustedIt = m_schemaContainer.m_trustedIds.find(signerKeyName);
+      if (trustedIt == m_schemaContainer.m_trustedIds.end() || !ndnBLSVerify(trustedIt->second, keyData)) {
+        NDN_LOG_ERROR("Cannot verify the static ECDH key of " << signerKeyName);
+        onFetched(false);
+        return;
+      }
+      try {
+        const auto& content = keyData.getContent();
+        content.parse();
+        const auto& ecdhBlock = content.get(tlv::EcdhPub);
+        m_signerStaticKeys[signerKeyName] = std::vector<uint8_t>(ecdhBlock.value(),
+                                                                 ecdhBlock.value() + ecdhBlock.value_size());
+      }
+      catch (const std::exception& e) {
+        NDN_LOG_ERROR("Bad static ECDH key Data from " << signerKeyName << ": " << e.what());
+        onFetched(false);
+        return;
+      }
+      onFetched(true);
+    },
+    [=](const auto&, const auto&) { onFetched(false); },
+    [=](const auto&) { onFetched(false); });
+}
+
+void
+MPSInitiator::performInlineRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlobalState> globalState)
+{
+  if (globalState->m_isFinished) {
+    return;
+  }
+  auto staticKeyIt = m_signerStaticKeys.find(signerKeyName);
+  if (staticKeyIt == m_signerStaticKeys.end()) {
+    fetchSignerStaticKey(signerKeyName, [=](bool isFetched) {
+      if (globalState->m_isFinished) {
+        // finished, expired or hedged while the key was fetched
+        return;
+      }
+      if (isFetched) {
+        performInlineRPC(signerKeyName, globalState);
+      }
+      else {
+        performRPC(signerKeyName, globalState);
+      }
+    });
+    return;
+  }
+
+  // ECDH with the signer's static key
+  auto ecdh = m_ecdhKeyPool->acquire();
+  auto dhSecret = ecdh->deriveSecret(staticKeyIt->second);
+  std::array<uint8_t, 32> salt;
+  random::generateSecureBytes(salt.data(), salt.size());
+  std::array<uint8_t, 48> aesAndHmac;
+  hkdf(dhSecret.data(), dhSecret.size(), salt.data(), salt.size(), aesAndHmac.data(), aesAndHmac.size());
+
+  // send sign request Interest with the encrypted unsigned Data inline
+  const auto& unfinishedWire = globalState->m_toBeSigned.front().wireEncode();
+  auto signRequestInt = prepareInlineSignRequestInterest(signerKeyName, ecdh->getSelfPubKey(),
+                                                         salt.data(), aesAndHmac.data(),
+                                                         unfinishedWire.wire(), unfinishedWire.size());
+  m_interestSigner.makeSignedInterest(signRequestInt, signingByKey(globalState->m_signingKeyName));
+  std::cout << "\n\nInitiator: Send inline MPS Sign Interest to signer: "
+            << signerKeyName.getPrefix(-2).toUri() << std::endl;
+  globalState->m_pendingInterests[signerKeyName] = m_face.expressInterest(
+    signRequestInt,
+    [=](const auto&, const auto& replyData)
+    {
+      std::string code;
+      Block resultContentBlock;
+      try {
+        const auto& contentBlock = replyData.getContent();
+        contentBlock.parse();
+        code = readString(contentBlock.get(tlv::Status));
+        if (code == "200") {
+          if (!verifyDataWithHmac(replyData, aesAndHmac.data() + 16, 32)) {
+            NDN_THROW(std::runtime_error("HMAC verification failed"));
+          }
+          auto decryptedBuf = decodeBlockWithAesGcm128(contentBlock, aesAndHmac.data(), nullptr, 0);
+          resultContentBlock = makeBinaryBlock(ndn::tlv::Content, decryptedBuf.data(), decryptedBuf.size());
+          resultContentBlock.parse();
+        }
+        else {
+          // error replies are signed with the BLS key of the signer
+          auto trustedIt = m_schemaContainer.m_trustedIds.find(signerKeyName);
+          if (trustedIt == m_schemaContainer.m_trustedIds.end() || !ndnBLSVerify(trustedIt->second, replyData)) {
+            NDN_THROW(std::runtime_error("Signature verification of the error reply failed"));
+          }
+        }
+      }
+      catch (const std::exception& e) {
+        NDN_LOG_ERROR("Bad inline sign reply from " << signerKeyName << ": " << e.what());
+        code = "500";
+      }
+      if (code == "200") {
+        onSignatureShare(signerKeyName, readSignatureShares(resultContentBlock), MpsSignerList(), globalState);
+      }
+      else if (code == "400") {
+        // the signer cannot decrypt the request, e.g., its static key has changed. Use the full protocol.
+        m_signerStaticKeys.erase(signerKeyName);
+        performRPC(signerKeyName, globalState);
+      }
+      else if (code == "503") {
+        onOverloadedSigner(signerKeyName, readRetryAfter(replyData), globalState);
+      }
+      else {
+        onUnavailableSigner("Received Error code " + code + " when requesting signer " +
+                            signerKeyName.getPrefix(-2).toUri(),
+                            signerKeyName, globalState);
+      }
+    },
+    [=](const Interest& interest, const lp::Nack& nack)
+    {
+      NDN_LOG_ERROR("Received NACK with reason " << nack.getReason() << " for " << interest.getName());
+      onUnavailableSigner("Received NACK when requesting signer " + signerKeyName.getPrefix(-2).toUri(),
+                          signerKeyName, globalState);
+    },
+    [=](const Interest& interest)
+    {
+      NDN_LOG_ERROR("Interest time out for " << interest.getName());
+      onUnavailableSigner("Interest timeout when requesting signer " + signerKeyName.getPrefix(-2).toUri(),
+                          signerKeyName, globalState);
+    });
+}
+
 void
 MPSInitiator::multiPartySign(const Data& unsignedData, const MultipartySchema& schema, const Name& signingKeyName,
                              const SignatureFinishCallback& successCb, const SignatureFailureCallback& failureCb)
 {
+  multiPartySignBatch(std::vector<Data>{unsignedData}, schema, signingKeyName,
+                      [successCb] (const std::vector<Data>& data, const Data& signerListData) {
+                        successCb(data.front(), signerListData);
+                      },
+                      failureCb);
+}
+
+void
+MPSInitiator::multiPartySignBatch(const std::vector<Data>& unsignedData, const MultipartySchema& schema,
+                                  const Name& signingKeyName,
+                                  const BatchSignatureFinishCallback& successCb,
+                                  const SignatureFailureCallback& failureCb)
+{
+  if (unsignedData.empty() || unsignedData.size() > MAX_BATCH_SIZE) {
+    failureCb("The batch must have 1 to " + std::to_string(MAX_BATCH_SIZE) + " packets.");
+    return;
+  }
   // init global state
   auto globalState = std::make_shared<MultiSignGlobalState>();
   globalState->m_schema = schema;
   globalState->m_successCb = successCb;
   globalState->m_failureCb = failureCb;
   globalState->m_signingKeyName = signingKeyName;
+  // prepare the packet to be signed and the signature info packet
+  std::tie(globalState->m_toBeSigned,
+           globalState->m_signInfo) = prepareUnfinishedDataAndInfoData(unsignedData, m_prefix);
+  startSession(globalState);
+}
+
+void
+MPSInitiator::aggregatePartial(const std::vector<Data>& toBeSigned, const MultipartySchema& schema,
+                               const Name& signingKeyName,
+                               const PartialAggregateCallback& successCb, const SignatureFailureCallback& failureCb)
+{
+  if (toBeSigned.empty() || toBeSigned.size() > MAX_BATCH_SIZE) {
+    failureCb("The batch must have 1 to " + std::to_string(MAX_BATCH_SIZE) + " packets.");
+    return;
+  }
+  auto globalState = std::make_shared<MultiSignGlobalState>();
+  globalState->m_schema = schema;
+  globalState->m_partialCb = successCb;
+  globalState->m_failureCb = failureCb;
+  globalState->m_signingKeyName = signingKeyName;
+  // the packets already point to the signature info of the root initiator
+  globalState->m_toBeSigned = toBeSigned;
+  startSession(globalState);
+}
+
+void
+MPSInitiator::startSession(std::shared_ptr<MultiSignGlobalState> globalState)
+{
+  const auto& failureCb = globalState->m_failureCb;
   // get signer list
-  globalState->m_signers = m_schemaContainer.getAvailableSigners(schema);
+  globalState->m_signers = m_schemaContainer.getAvailableSigners(globalState->m_schema);
   if (globalState->m_signers.m_signers.size() == 0) {
     failureCb("No sufficient number of known signers.");
+    return;
+  }
+  // hedging: also ask extra optional signers and finish with whichever shares pass the schema first
+  if (m_maxHedgedSigners > 0) {
+    auto extraSigners = m_schemaContainer.getHedgeSigners(globalState->m_schema, globalState->m_signers,
+                                                          m_maxHedgedSigners);
+    globalState->m_signers.m_signers.insert(globalState->m_signers.m_signers.end(),
+                                           extraSigners.begin(), extraSigners.end());
+  }
+  if (encodeParameterBatch(globalState->m_toBeSigned).size() + PARAMETER_DATA_OVERHEAD > MAX_NDN_PACKET_SIZE) {
+    failureCb("The batch does not fit in one parameter Data, split it into smaller batches.");
+    return;
+  }
+  globalState->m_aggregators.resize(globalState->m_toBeSigned.size());
+  if (!addSession(globalState)) {
+    failureCb("Too many signing sessions in flight, try again later.");
+    return;
+  }
+  if (m_isGroupParameterMode) {
+    // encrypt the parameter once under a random content key, each signer gets the key wrapped with its own key
+    random::generateSecureBytes(globalState->m_contentKey.data(), globalState->m_contentKey.size());
+    auto groupParaData = prepareParameterData(globalState->m_toBeSigned, m_prefix);
+    const auto& unencryptedBlock = groupParaData.getContent();
+    groupParaData.setContent(encodeBlockWithAesGcm128(ndn::tlv::Content, globalState->m_contentKey.data(),
+                                                      unencryptedBlock.value(), unencryptedBlock.value_size(),
+                                                      nullptr, 0));
+    m_keyChain.sign(groupParaData, signingWithSha256());
+    globalState->m_groupParameterName = groupParaData.getFullName();
+    // replacement signers may fetch it late in the session, so it does not expire with the per-signer handlers
+    globalState->m_groupParameterId = groupParaData.getName().get(-1).toNumber();
+    std::weak_ptr<MultiSignGlobalState> weakGlobalState = globalState;
+    m_parameterHandlers[globalState->m_groupParameterId] =
+      [this, groupParaData, weakGlobalState](const Interest&) {
+        auto globalState = weakGlobalState.lock();
+        if (globalState != nullptr && !globalState->m_isFinished) {
+          m_face.put(groupParaData);
+        }
+      };
   }
-  // prepare the packet to be signed and the signature info packet
-  std::tie(globalState->m_toBeSigned,
-           globalState->m_signInfo) = prepareUnfinishedDataAndInfoData(unsignedData, m_prefix);
 
   for (const Name& signerKeyName : globalState->m_signers.m_signers) {
     // perform RPC with each signer
-    performRPC(signerKeyName, globalState);
+    requestSignature(signerKeyName, globalState);
   }
 }
 
+bool
+MPSInitiator::addSession(std::shared_ptr<MultiSignGlobalState> globalState)
+{
+  if (m_maxSessions > 0 && m_sessions.size() >= m_maxSessions) {
+    m_nRejectedSessions++;
+    return false;
+  }
+  // the packets, and a copy of them in the parameter Data of each signer unless shared in the group mode
+  size_t packetSize = 0;
+  for (const auto& item : globalState->m_toBeSigned) {
+    packetSize += item.wireEncode().size();
+  }
+  size_t nSigners = globalState->m_signers.m_signers.size();
+  size_t nParameterCopies = m_isGroupParameterMode ? 1 : nSigners;
+  globalState->m_estimatedSize = sizeof(MultiSignGlobalState) + packetSize * (1 + nParameterCopies) +
+                                 nSigners * (sizeof(MultiSignPerSignerState) + sizeof(SignatureAggregator) +
+                                             globalState->m_toBeSigned.size() * sizeof(BLSSignature));
+  globalState->m_sessionId = ++m_lastSessionId;
+  m_sessions.emplace(globalState->m_sessionId, globalState);
+  m_liveSessionBytes += globalState->m_estimatedSize;
+
+  if (m_sessionDeadline > time::milliseconds(0)) {
+    std::weak_ptr<MultiSignGlobalState> weakGlobalState = globalState;
+    globalState->m_deadlineEvent = m_scheduler.schedule(m_sessionDeadline, [this, weakGlobalState] {
+      auto globalState = weakGlobalState.lock();
+      if (globalState == nullptr || globalState->m_isFinished) {
+        return;
+      }
+      std::string waitingFor;
+      for (const auto& item : globalState->m_signers.m_signers) {
+        if (!globalState->m_aggregators.front().contains(item)) {
+          waitingFor += " " + item.getPrefix(-2).toUri();
+        }
+      }
+      m_nExpiredSessions++;
+      markSessionFinished(globalState);
+      globalState->m_failureCb("Session deadline exceeded when waiting for signers" + waitingFor);
+    });
+  }
+  return true;
+}
+
+void
+MPSInitiator::onOverloadedSigner(const Name& signerKeyName, time::milliseconds retryAfter,
+                                 std::shared_ptr<MultiSignGlobalState> globalState)
+{
+  NDN_LOG_INFO("Signer " << signerKeyName << " is overloaded, retry after " << retryAfter);
+  m_overloadedSigners[signerKeyName] = m_scheduler.schedule(retryAfter, [this, signerKeyName] {
+    m_schemaContainer.m_unavailableSigners.erase(signerKeyName);
+    m_overloadedSigners.erase(signerKeyName);
+  });
+  onUnavailableSigner("Signer " + signerKeyName.getPrefix(-2).toUri() + " is overloaded",
+                      signerKeyName, globalState);
+}
+
 void
 MPSInitiator::onUnavailableSigner(const std::string& reason,
                                   const Name& unavailbleSignerKeyName,
                                   std::shared_ptr<MultiSignGlobalState> globalState)
 {
+  if (globalState->m_isFinished) {
+    return;
+  }
+  auto pendingIt = globalState->m_pendingInterests.find(unavailbleSignerKeyName);
+  if (pendingIt != globalState->m_pendingInterests.end()) {
+    pendingIt->second.cancel();
+    globalState->m_pendingInterests.erase(pendingIt);
+  }
+  globalState->m_subSigners.erase(unavailbleSignerKeyName);
+  for (auto& aggregator : globalState->m_aggregators) {
+    aggregator.remove(unavailbleSignerKeyName);
+  }
+  auto stateIt = globalState->m_perSignerStates.find(unavailbleSignerKeyName);
+  if (stateIt != globalState->m_perSignerStates.end()) {
+    concludeResultFetch(*stateIt->second);
+    releasePerSignerState(*stateIt->second);
+    globalState->m_perSignerStates.erase(stateIt);
+  }
+  // the signers still asked may pass the schema without a replacement, e.g., when a hedged signer fails
+  std::vector<Name> remainingSigners;
+  for (const auto& item : globalState->m_signers.m_signers) {
+    if (item != unavailbleSignerKeyName) {
+      remainingSigners.push_back(item);
+    }
+  }
+  if (remainingSigners.size() < globalState->m_signers.m_signers.size() &&
+      globalState->m_schema.passSchema(remainingSigners)) {
+    m_schemaContainer.m_unavailableSigners.insert(unavailbleSignerKeyName);
+    globalState->m_signers = MpsSignerList(remainingSigners);
+    return;
+  }
   MpsSignerList newSigners;
   std::vector<Name> diffSigners;
   std::tie(newSigners, diffSigners) = m_schemaContainer.replaceSigner(globalState->m_signers,
                                                                       unavailbleSignerKeyName,
                                                                       globalState->m_schema);
   if (newSigners.m_signers.empty()) {
+    markSessionFinished(globalState);
     globalState->m_failureCb(reason + " And we cannot find replacements for the unavailable signer");
   }
   else {
     globalState->m_signers = newSigners;
     for (const auto& item : diffSigners) {
-      performRPC(item, globalState);
+      requestSignature(item, globalState);
     }
   }
 }
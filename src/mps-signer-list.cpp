@@ -55,6 +55,19 @@ MpsSignerList::wireDecode(const Block& wire)
   }
 }
 
+bool
+MpsSignerList::merge(const MpsSignerList& other)
+{
+  std::set<Name> names(m_signers.begin(), m_signers.end());
+  for (const auto& item : other.m_signers) {
+    if (!names.insert(item).second) {
+      return false;
+    }
+  }
+  m_signers.insert(m_signers.end(), other.m_signers.begin(), other.m_signers.end());
+  return true;
+}
+
 std::ostream&
 operator<<(std::ostream& os, const MpsSignerList& signerList)
 {
@@ -0,0 +1,94 @@
+#include "ndnmps/publication-store.hpp"
+
+namespace ndn {
+namespace mps {
+
+PublicationStore::PublicationStore(size_t capacity, size_t maxBytes)
+  : m_capacity(capacity)
+  , m_maxBytes(maxBytes)
+{
+}
+
+void
+PublicationStore::insert(const Data& data, time::milliseconds lifetime)
+{
+  if (m_capacity == 0) {
+    return;
+  }
+  auto indexIt = m_index.find(data.getName());
+  if (indexIt != m_index.end()) {
+    eraseEntry(indexIt);
+  }
+  m_entries.push_front(Entry{data, time::steady_clock::now() + lifetime});
+  m_index.emplace(data.getName(), m_entries.begin());
+  m_nBytes += data.wireEncode().size();
+  evictOverLimits();
+}
+
+const Data*
+PublicationStore::find(const Interest& interest)
+{
+  const auto& name = interest.getName();
+  auto now = time::steady_clock::now();
+  // an Interest with the implicit digest names the Data under its prefix
+  bool hasDigest = !name.empty() && name.get(-1).isImplicitSha256Digest();
+  auto indexIt = m_index.lower_bound(hasDigest ? name.getPrefix(-1) : name);
+  while (indexIt != m_index.end() && (hasDigest ? indexIt->first == name.getPrefix(-1)
+                                                : name.isPrefixOf(indexIt->first))) {
+    auto entryIt = indexIt->second;
+    if (entryIt->m_expiry <= now) {
+      eraseEntry(indexIt++);
+      continue;
+    }
+    if (interest.matchesData(entryIt->m_data)) {
+      // move to the front as the most recently used
+      m_entries.splice(m_entries.begin(), m_entries, entryIt);
+      m_nHits++;
+      return &entryIt->m_data;
+    }
+    if (!interest.getCanBePrefix() || hasDigest) {
+      break;
+    }
+    indexIt++;
+  }
+  m_nMisses++;
+  return nullptr;
+}
+
+bool
+PublicationStore::erase(const Name& dataName)
+{
+  auto indexIt = m_index.find(dataName);
+  if (indexIt == m_index.end()) {
+    return false;
+  }
+  eraseEntry(indexIt);
+  return true;
+}
+
+void
+PublicationStore::setLimits(size_t capacity, size_t maxBytes)
+{
+  m_capacity = capacity;
+  m_maxBytes = maxBytes;
+  evictOverLimits();
+}
+
+void
+PublicationStore::eraseEntry(std::map<Name, EntryList::iterator>::iterator indexIt)
+{
+  m_nBytes -= indexIt->second->m_data.wireEncode().size();
+  m_entries.erase(indexIt->second);
+  m_index.erase(indexIt);
+}
+
+void
+PublicationStore::evictOverLimits()
+{
+  while (!m_entries.empty() && (m_entries.size() > m_capacity || m_nBytes > m_maxBytes)) {
+    eraseEntry(m_index.find(m_entries.back().m_data.getName()));
+  }
+}
+
+}  // namespace mps
+}  // namespace ndn
@@ -0,0 +1,82 @@
+#include "ndnmps/result-poller.hpp"
+#include <ndn-cxx/util/random.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace ndn {
+namespace mps {
+
+ResultPoller::ResultPoller(const ResultPollerOptions& options)
+  : m_options(options)
+{
+}
+
+void
+ResultPoller::recordServiceTime(const Name& signerKeyName, time::milliseconds serviceTime)
+{
+  auto& samples = m_serviceTimes[signerKeyName];
+  samples.push_back(serviceTime);
+  while (samples.size() > m_options.historySize) {
+    samples.pop_front();
+  }
+}
+
+time::milliseconds
+ResultPoller::getFirstDelay(const Name& signerKeyName, time::milliseconds resultAfter) const
+{
+  if (resultAfter <= time::milliseconds(0)) {
+    return time::milliseconds(0);
+  }
+  auto it = m_serviceTimes.find(signerKeyName);
+  if (it == m_serviceTimes.end() || it->second.empty()) {
+    return resultAfter;
+  }
+  std::vector<time::milliseconds> samples(it->second.begin(), it->second.end());
+  auto rank = static_cast<size_t>(std::ceil(m_options.percentile * samples.size()));
+  rank = std::min(std::max<size_t>(rank, 1), samples.size()) - 1;
+  std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+  return samples[rank];
+}
+
+time::milliseconds
+ResultPoller::getRetryDelay(size_t nRetries, time::milliseconds resultAfter) const
+{
+  if (resultAfter <= time::milliseconds(0)) {
+    return time::milliseconds(0);
+  }
+  double delay = m_options.minInterval.count() * std::pow(m_options.backoffFactor, nRetries);
+  delay = std::min(delay, static_cast<double>(m_options.maxInterval.count()));
+  std::uniform_real_distribution<double> dist(1 - m_options.jitter, 1 + m_options.jitter);
+  delay *= dist(random::getRandomNumberEngine());
+  return time::milliseconds(static_cast<time::milliseconds::rep>(delay));
+}
+
+void
+ResultPoller::submit(const std::function<void()>& fetch)
+{
+  if (m_nOutstanding >= m_options.maxOutstanding) {
+    m_queue.push_back(fetch);
+    return;
+  }
+  m_nOutstanding++;
+  fetch();
+}
+
+void
+ResultPoller::onFetchDone()
+{
+  if (m_nOutstanding > 0) {
+    m_nOutstanding--;
+  }
+  if (!m_queue.empty() && m_nOutstanding < m_options.maxOutstanding) {
+    auto fetch = std::move(m_queue.front());
+    m_queue.pop_front();
+    m_nOutstanding++;
+    fetch();
+  }
+}
+
+}  // namespace mps
+}  // namespace ndn
@@ -338,6 +338,25 @@ MultipartySchemaContainer::replaceSigner(const MpsSignerList& signers,
                          std::vector<Name>(diffSet.begin(), diffSet.end()));
 }
 
+std::vector<Name>
+MultipartySchemaContainer::getHedgeSigners(const MultipartySchema& schema, const MpsSignerList& signers,
+                                           size_t maxExtraSigners) const
+{
+  std::set<Name> existingSigners(signers.m_signers.begin(), signers.m_signers.end());
+  std::vector<Name> extraSigners;
+  for (const auto& pattern : schema.m_optionalSigners) {
+    for (const auto& matchedKey : getMatchedKeys(pattern)) {
+      if (extraSigners.size() >= maxExtraSigners) {
+        return extraSigners;
+      }
+      if (existingSigners.insert(matchedKey).second) {
+        extraSigners.push_back(matchedKey);
+      }
+    }
+  }
+  return extraSigners;
+}
+
 std::vector<Name>
 MultipartySchemaContainer::getMatchedKeys(const WildCardName& pattern) const
 {
@@ -0,0 +1,89 @@
+#include "ndnmps/session-cache.hpp"
+
+namespace ndn {
+namespace mps {
+
+SessionCache::SessionCache(time::milliseconds lifetime, size_t capacity)
+  : m_lifetime(lifetime)
+  , m_capacity(capacity)
+{
+}
+
+void
+SessionCache::insert(const ResumableSession& session)
+{
+  if (m_sessions.size() >= m_capacity) {
+    removeExpired();
+  }
+  if (m_sessions.size() >= m_capacity) {
+    // still full, drop the session that expires first
+    auto victim = m_sessions.begin();
+    for (auto it = m_sessions.begin(); it != m_sessions.end(); it++) {
+      if (it->second.m_expiry < victim->second.m_expiry) {
+        victim = it;
+      }
+    }
+    erase(victim->first);
+  }
+  m_sessions[session.m_id] = session;
+  m_peerIndex[session.m_peer] = session.m_id;
+}
+
+const ResumableSession*
+SessionCache::find(uint64_t sessionId)
+{
+  auto it = m_sessions.find(sessionId);
+  if (it == m_sessions.end()) {
+    return nullptr;
+  }
+  if (it->second.m_expiry <= time::steady_clock::now()) {
+    erase(sessionId);
+    return nullptr;
+  }
+  return &it->second;
+}
+
+const ResumableSession*
+SessionCache::findByPeer(const Name& peer)
+{
+  auto it = m_peerIndex.find(peer);
+  if (it == m_peerIndex.end()) {
+    return nullptr;
+  }
+  return find(it->second);
+}
+
+void
+SessionCache::erase(uint64_t sessionId)
+{
+  auto it = m_sessions.find(sessionId);
+  if (it == m_sessions.end()) {
+    return;
+  }
+  auto peerIt = m_peerIndex.find(it->second.m_peer);
+  if (peerIt != m_peerIndex.end() && peerIt->second == sessionId) {
+    m_peerIndex.erase(peerIt);
+  }
+  m_sessions.erase(it);
+}
+
+void
+SessionCache::removeExpired()
+{
+  auto now = time::steady_clock::now();
+  for (auto it = m_sessions.begin(); it != m_sessions.end();) {
+    if (it->second.m_expiry <= now) {
+      auto peerIt = m_peerIndex.find(it->second.m_peer);
+      if (peerIt != m_peerIndex.end() && peerIt->second == it->first) {
+        m_peerIndex.erase(peerIt);
+      }
+      it = m_sessions.erase(it);
+    }
+    else {
+      it++;
+    }
+  }
+}
+
+}  // namespace mps
+}  // namespace ndn
@@ -0,0 +1,82 @@
+#include "ndnmps/signature-aggregator.hpp"
+
+namespace ndn {
+namespace mps {
+
+bool
+SignatureAggregator::add(const Name& signerKeyName, const Buffer& share)
+{
+  BLSSignature sig;
+  if (blsSignatureDeserialize(&sig, share.data(), share.size()) == 0) {
+    return false;
+  }
+  remove(signerKeyName);
+  if (m_contributions.empty()) {
+    m_aggregate = sig;
+  }
+  else {
+    blsSignatureAdd(&m_aggregate, &sig);
+  }
+  m_contributions.emplace(signerKeyName, sig);
+  return true;
+}
+
+void
+SignatureAggregator::remove(const Name& signerKeyName)
+{
+  auto it = m_contributions.find(signerKeyName);
+  if (it == m_contributions.end()) {
+    return;
+  }
+  if (m_contributions.size() > 1) {
+    blsSignatureSub(&m_aggregate, &it->second);
+  }
+  m_contributions.erase(it);
+}
+
+std::vector<Name>
+SignatureAggregator::getSigners() const
+{
+  std::vector<Name> signers;
+  for (const auto& item : m_contributions) {
+    signers.push_back(item.first);
+  }
+  return signers;
+}
+
+Buffer
+SignatureAggregator::getSignature() const
+{
+  if (m_contributions.empty()) {
+    NDN_THROW(std::runtime_error("No signature share has been aggregated"));
+  }
+  uint8_t encodingBuf[128];
+  auto sigSize = blsSignatureSerialize(encodingBuf, sizeof(encodingBuf), &m_aggregate);
+  return Buffer(encodingBuf, sigSize);
+}
+
+std::vector<Name>
+SignatureAggregator::findInvalidShares(const std::map<Name, BLSPublicKey>& trustedKeys, const Data& data) const
+{
+  std::vector<Name> invalidSigners;
+  std::vector<Name> signers;
+  std::vector<BLSPublicKey> pubKeys;
+  std::vector<BLSSignature> shares;
+  for (const auto& item : m_contributions) {
+    auto keyIt = trustedKeys.find(item.first);
+    if (keyIt == trustedKeys.end()) {
+      invalidSigners.push_back(item.first);
+      continue;
+    }
+    signers.push_back(item.first);
+    pubKeys.push_back(keyIt->second);
+    shares.push_back(item.second);
+  }
+  for (auto index : ndnBLSFindInvalidShares(pubKeys, shares, data)) {
+    invalidSigners.push_back(signers[index]);
+  }
+  return invalidSigners;
+}
+
+}  // namespace mps
+}  // namespace ndn
@@ -0,0 +1,91 @@
+#include "ndnmps/signature-cache.hpp"
+#include <ndn-cxx/util/sha256.hpp>
+
+namespace ndn {
+namespace mps {
+
+SignedPortionDigest
+computeSignedPortionDigest(const Data& dataWithInfo)
+{
+  EncodingBuffer encoder;
+  dataWithInfo.wireEncode(encoder, true);
+  auto digestBuf = util::Sha256::computeDigest(encoder.buf(), encoder.size());
+  SignedPortionDigest digest;
+  std::copy(digestBuf->begin(), digestBuf->end(), digest.begin());
+  return digest;
+}
+
+SignatureCache::SignatureCache(size_t capacity, time::milliseconds ttl)
+  : m_capacity(capacity)
+  , m_ttl(ttl)
+{
+}
+
+const Buffer*
+SignatureCache::find(const Name& keyName, const SignedPortionDigest& digest)
+{
+  auto it = m_index.find(Key(keyName, digest));
+  if (it == m_index.end()) {
+    m_nMisses++;
+    return nullptr;
+  }
+  if (it->second->m_expiry <= time::steady_clock::now()) {
+    m_entries.erase(it->second);
+    m_index.erase(it);
+    m_nMisses++;
+    return nullptr;
+  }
+  // move to the front as the most recently used
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  m_nHits++;
+  return &it->second->m_signatureValue;
+}
+
+void
+SignatureCache::insert(const Name& keyName, const SignedPortionDigest& digest, const Buffer& signatureValue)
+{
+  if (m_capacity == 0) {
+    return;
+  }
+  Key key(keyName, digest);
+  auto it = m_index.find(key);
+  if (it != m_index.end()) {
+    m_entries.erase(it->second);
+    m_index.erase(it);
+  }
+  m_entries.push_front(Entry{key, signatureValue, time::steady_clock::now() + m_ttl});
+  m_index.emplace(key, m_entries.begin());
+  evictOverCapacity();
+}
+
+size_t
+SignatureCache::eraseKey(const Name& keyName)
+{
+  size_t nErased = 0;
+  auto it = m_index.lower_bound(Key(keyName, SignedPortionDigest{}));
+  while (it != m_index.end() && it->first.first == keyName) {
+    m_entries.erase(it->second);
+    it = m_index.erase(it);
+    nErased++;
+  }
+  return nErased;
+}
+
+void
+SignatureCache::setCapacity(size_t capacity)
+{
+  m_capacity = capacity;
+  evictOverCapacity();
+}
+
+void
+SignatureCache::evictOverCapacity()
+{
+  while (m_entries.size() > m_capacity) {
+    m_index.erase(m_entries.back().m_key);
+    m_entries.pop_back();
+  }
+}
+
+}  // namespace mps
+}  // namespace ndn
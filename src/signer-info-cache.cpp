@@ -0,0 +1,67 @@
+#include "ndnmps/signer-info-cache.hpp"
+#include <algorithm>
+
+namespace ndn {
+namespace mps {
+
+SignerInfoCache::SignerInfoCache(size_t capacity, time::milliseconds maxTtl)
+  : m_capacity(capacity)
+  , m_maxTtl(maxTtl)
+{
+}
+
+const MpsSignerList*
+SignerInfoCache::find(const Name& keyLocatorName)
+{
+  auto it = m_index.find(keyLocatorName);
+  if (it == m_index.end()) {
+    m_nMisses++;
+    return nullptr;
+  }
+  if (it->second->m_expiry <= time::steady_clock::now()) {
+    m_entries.erase(it->second);
+    m_index.erase(it);
+    m_nMisses++;
+    return nullptr;
+  }
+  // move to the front as the most recently used
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  m_nHits++;
+  return &it->second->m_signers;
+}
+
+void
+SignerInfoCache::insert(const Name& keyLocatorName, const MpsSignerList& signers, time::milliseconds freshnessPeriod)
+{
+  if (m_capacity == 0) {
+    return;
+  }
+  auto it = m_index.find(keyLocatorName);
+  if (it != m_index.end()) {
+    m_entries.erase(it->second);
+    m_index.erase(it);
+  }
+  auto ttl = freshnessPeriod > time::milliseconds(0) ? std::min(freshnessPeriod, m_maxTtl) : m_maxTtl;
+  m_entries.push_front(Entry{keyLocatorName, signers, time::steady_clock::now() + ttl});
+  m_index.emplace(keyLocatorName, m_entries.begin());
+  evictOverCapacity();
+}
+
+void
+SignerInfoCache::setCapacity(size_t capacity)
+{
+  m_capacity = capacity;
+  evictOverCapacity();
+}
+
+void
+SignerInfoCache::evictOverCapacity()
+{
+  while (m_entries.size() > m_capacity) {
+    m_index.erase(m_entries.back().m_keyLocatorName);
+    m_entries.pop_back();
+  }
+}
+
+}  // namespace mps
+}  // namespace ndn
@@ -5,6 +5,7 @@
 #include <ndn-cxx/security/transform/base64-decode.hpp>
 #include <ndn-cxx/security/transform/buffer-source.hpp>
 #include <ndn-cxx/security/verification-helpers.hpp>
+#include <algorithm>
 #include <utility>
 #include <future>
 #include <iostream>
@@ -16,85 +17,170 @@ NDN_LOG_INIT(ndnmps.blssigner);
 
 const time::milliseconds TIMEOUT = time::seconds(4);
 const time::milliseconds ESTIMATE_PROCESS_TIME = time::seconds(1);
-const static Name HMAC_KEY_PREFIX("/ndn/mps/hmac"); // append request ID when being used
+const time::milliseconds STATIC_ECDH_KEY_FRESHNESS = time::hours(1);
+// a held result Interest is answered this long before it expires at the initiator
+const time::milliseconds LONG_POLL_MARGIN = time::milliseconds(200);
 
 struct SignRequestState
 {
-  ECDHState m_ecdh;
+  uint64_t m_requestId;
+  std::unique_ptr<ECDHState> m_ecdh;
   std::array<uint8_t, 16> m_aesKey;
   ReplyCode m_code;
-  Buffer m_signatureValue;
+  std::vector<Buffer> m_signatureValues; // one per packet of the batch
+  MpsSignerList m_contributors; // delegated signing: the signers aggregated in the signature values
   size_t m_version;
-  RegisteredPrefixHandle m_resultPrefixHandle;
-  security::SigningInfo m_hmacSigningInfo;
+  InterestFilterHandle m_resultPrefixHandle;
+  std::array<uint8_t, 32> m_hmacKey;
+  Name m_keyName; // the hosted key that signs the request
+  Name m_resultPrefix;
+  // long-poll: name of the result Interest held until the result is ready, empty if none
+  Name m_heldResultName;
+  scheduler::ScopedEventId m_holdEvent;
+  // group mode: the shared parameter Data and the content key it is encrypted with, which arrive separately
+  Name m_groupParameterName;
+  Data m_groupParameterData;
+  std::array<uint8_t, 16> m_contentKey;
+  bool m_hasGroupParameterData = false;
+  bool m_hasContentKey = false;
+  // reported to the initiator in the result: the time from the ACK until the result is ready
+  time::steady_clock::TimePoint m_ackTime;
+  time::milliseconds m_serviceTime = time::milliseconds(0);
+  // request table bookkeeping
+  size_t m_size;
+  std::list<uint64_t>::iterator m_orderIt;
+  scheduler::ScopedEventId m_expiryEvent;
 };
 
 /**
  * @brief Parse sign request Interest packet's application parameters.
+ *
+ * A full handshake carries the peer's ECDH public key. A resumed session carries
+ * the session ID and a request nonce instead, and @p peerPubKey is left empty.
+ * In group mode, @p groupParameterName is the full name of the parameter Data shared by all signers.
  */
 void
-parseSignRequestPayload(const Interest& interest, Name& parameterDataName, std::vector<uint8_t>& peerPubKey)
+parseSignRequestPayload(const Interest& interest, Name& parameterDataName, Name& groupParameterName,
+                        std::vector<uint8_t>& peerPubKey, uint64_t& sessionId, std::array<uint8_t, 32>& nonce)
 {
   const auto& paramBlock = interest.getApplicationParameters();
   paramBlock.parse();
   parameterDataName.wireDecode(paramBlock.get(tlv::ParameterDataName).blockFromValue());
-  const auto& ecdhBlock = paramBlock.get(tlv::EcdhPub);
-  peerPubKey.resize(ecdhBlock.value_size());
-  std::memcpy(peerPubKey.data(), ecdhBlock.value(), ecdhBlock.value_size());
+  auto groupNameIt = paramBlock.find(tlv::GroupParameterName);
+  if (groupNameIt != paramBlock.elements_end()) {
+    groupParameterName.wireDecode(groupNameIt->blockFromValue());
+  }
+  auto ecdhIt = paramBlock.find(tlv::EcdhPub);
+  if (ecdhIt != paramBlock.elements_end()) {
+    peerPubKey.resize(ecdhIt->value_size());
+    std::memcpy(peerPubKey.data(), ecdhIt->value(), ecdhIt->value_size());
+    return;
+  }
+  sessionId = readNonNegativeInteger(paramBlock.get(tlv::SessionId));
+  const auto& nonceBlock = paramBlock.get(tlv::Salt);
+  if (nonceBlock.value_size() != nonce.size()) {
+    NDN_THROW(std::runtime_error("Bad request nonce size"));
+  }
+  std::memcpy(nonce.data(), nonceBlock.value(), nonce.size());
+}
+
+/**
+ * @brief Get the key name of the initiator that signed the sign request.
+ */
+Name
+getRequesterKeyName(const Interest& interest)
+{
+  auto sigInfo = interest.getSignatureInfo();
+  if (sigInfo && sigInfo->hasKeyLocator() && sigInfo->getKeyLocator().getType() == ndn::tlv::Name) {
+    return sigInfo->getKeyLocator().getName();
+  }
+  return Name();
 }
 
 /**
  * @brief Generate unsigned ACK data.
+ *
+ * The salt and the self ECDH public key are only carried in a full handshake.
+ * A non-zero @p sessionId offers the initiator to resume the session later.
  */
 Data
 generateSignRequestAck(const Name& interestName, const Name& selfPrefix, ReplyCode code, uint64_t requestId = 0,
                        const uint8_t* salt = nullptr, const uint8_t* selfPub = nullptr, size_t selfPubSize = 0,
-                       const uint8_t* aesKey = nullptr)
+                       const uint8_t* aesKey = nullptr,
+                       uint64_t sessionId = 0, time::milliseconds sessionLifetime = time::milliseconds(0),
+                       time::milliseconds resultAfter = ESTIMATE_PROCESS_TIME)
 {
   Data ack(interestName);
   if (code != ReplyCode::Processing) {
     Block contentBlock(ndn::tlv::Content);
-    contentBlock.push_back(makeStringBlock(tlv::Status, std::to_string(static_cast<int>(ReplyCode::Processing))));
+    contentBlock.push_back(makeStringBlock(tlv::Status, std::to_string(static_cast<int>(code))));
     ack.setContent(contentBlock);
     ack.setFreshnessPeriod(TIMEOUT);
     return ack;
   }
   Block unencryptedBlock(tlv::EncryptedPayload);
-  unencryptedBlock.push_back(makeNonNegativeIntegerBlock(tlv::ResultAfter, ESTIMATE_PROCESS_TIME.count()));
+  unencryptedBlock.push_back(makeNonNegativeIntegerBlock(tlv::ResultAfter, resultAfter.count()));
   Name newResultName = selfPrefix;
   newResultName.append("mps").append("result").appendNumber(requestId).appendVersion(0);
   unencryptedBlock.push_back(makeNestedBlock(tlv::ResultName, newResultName));
+  if (sessionId != 0) {
+    unencryptedBlock.push_back(makeNonNegativeIntegerBlock(tlv::SessionId, sessionId));
+    unencryptedBlock.push_back(makeNonNegativeIntegerBlock(tlv::SessionLifetime, sessionLifetime.count()));
+  }
   unencryptedBlock.encode();
   auto encryptedBlock = encodeBlockWithAesGcm128(ndn::tlv::Content, aesKey,
                                                  unencryptedBlock.value(), unencryptedBlock.value_size(),
                                                  nullptr, 0);
   encryptedBlock.push_back(makeStringBlock(tlv::Status, std::to_string(static_cast<int>(ReplyCode::Processing))));
-  encryptedBlock.push_back(makeBinaryBlock(tlv::Salt, salt, 32));
-  encryptedBlock.push_back(makeBinaryBlock(tlv::EcdhPub, selfPub, selfPubSize));
+  if (salt != nullptr) {
+    encryptedBlock.push_back(makeBinaryBlock(tlv::Salt, salt, 32));
+    encryptedBlock.push_back(makeBinaryBlock(tlv::EcdhPub, selfPub, selfPubSize));
+  }
   encryptedBlock.encode();
   ack.setContent(encryptedBlock);
   ack.setFreshnessPeriod(TIMEOUT);
   return ack;
 }
 
+/**
+ * @brief Generate unsigned reply data that rejects an overloaded request.
+ */
+Data
+generateUnavailableReply(const Name& interestName, time::milliseconds retryAfter)
+{
+  Data reply(interestName);
+  Block contentBlock(ndn::tlv::Content);
+  contentBlock.push_back(makeStringBlock(tlv::Status, std::to_string(static_cast<int>(ReplyCode::Unavailable))));
+  contentBlock.push_back(makeNonNegativeIntegerBlock(tlv::RetryAfter, retryAfter.count()));
+  reply.setContent(contentBlock);
+  // the hint is only valid for a short period
+  reply.setFreshnessPeriod(std::min(retryAfter, TIMEOUT));
+  return reply;
+}
+
 Data
-generateResultData(const Name& interestName, const Name& resultPrefix, std::shared_ptr<SignRequestState> statePtr)
+generateResultData(const Name& interestName, const Name& resultPrefix, std::shared_ptr<SignRequestState> statePtr,
+                   time::milliseconds resultAfter = ESTIMATE_PROCESS_TIME)
 {
   Data result(interestName);
   Block unencryptedBlock(tlv::EncryptedPayload);
   unencryptedBlock.push_back(makeStringBlock(tlv::Status, std::to_string(static_cast<int>(statePtr->m_code))));
   if (statePtr->m_code == ReplyCode::Processing) {
     statePtr->m_version += 1;
-    unencryptedBlock.push_back(makeNonNegativeIntegerBlock(tlv::ResultAfter, ESTIMATE_PROCESS_TIME.count()));
+    unencryptedBlock.push_back(makeNonNegativeIntegerBlock(tlv::ResultAfter, resultAfter.count()));
     Name newResultName = resultPrefix;
     newResultName.appendVersion(statePtr->m_version);
     unencryptedBlock.push_back(makeNestedBlock(tlv::ResultName, newResultName));
   }
   else if (statePtr->m_code == ReplyCode::OK) {
-    unencryptedBlock.push_back(makeBinaryBlock(tlv::BLSSigValue,
-                                               statePtr->m_signatureValue.data(),
-                                               statePtr->m_signatureValue.size()));
-    std::cout << "signature value length: " << statePtr->m_signatureValue.size() << std::endl;
+    for (const auto& signatureValue : statePtr->m_signatureValues) {
+      unencryptedBlock.push_back(makeBinaryBlock(tlv::BLSSigValue, signatureValue.data(), signatureValue.size()));
+    }
+    if (!statePtr->m_contributors.m_signers.empty()) {
+      unencryptedBlock.push_back(statePtr->m_contributors.wireEncode());
+    }
+    unencryptedBlock.push_back(makeNonNegativeIntegerBlock(tlv::ServiceTime, statePtr->m_serviceTime.count()));
+    NDN_LOG_DEBUG("Number of signature values: " << statePtr->m_signatureValues.size());
     statePtr->m_resultPrefixHandle.cancel();
   }
   else {
@@ -109,16 +195,38 @@ generateResultData(const Name& interestName, const Name& resultPrefix, std::shar
   return result;
 }
 
-Data
+/**
+ * @brief Decode the unsigned Data carried by a parameter: a single Data, or a ParameterBatch of Data.
+ */
+std::vector<Data>
+decodeParameterBatch(const Block& parameterBlock)
+{
+  std::vector<Data> batch;
+  if (parameterBlock.type() != tlv::ParameterBatch) {
+    batch.emplace_back(parameterBlock);
+    return batch;
+  }
+  parameterBlock.parse();
+  for (const auto& item : parameterBlock.elements()) {
+    batch.emplace_back(item);
+  }
+  if (batch.empty()) {
+    NDN_THROW(std::runtime_error("Empty parameter batch"));
+  }
+  return batch;
+}
+
+/**
+ * @brief Decrypt the per-signer parameter Data: the unsigned Data, or the content key in group mode.
+ */
+Block
 parseParameterData(const Data& data, std::shared_ptr<SignRequestState> statePtr)
 {
   auto contentBlock = data.getContent();
   contentBlock.parse();
-  Block dataBlock(std::make_shared<Buffer>(decodeBlockWithAesGcm128(contentBlock,
-                                                                    statePtr->m_aesKey.data(),
-                                                                    nullptr, 0)));
-  Data unsignedData(dataBlock);
-  return unsignedData;
+  return Block(std::make_shared<Buffer>(decodeBlockWithAesGcm128(contentBlock,
+                                                                 statePtr->m_aesKey.data(),
+                                                                 nullptr, 0)));
 }
 
 void
@@ -135,34 +243,533 @@ BLSSigner::BLSSigner(const Name& prefix, Face& face, KeyChain& keyChain,
   , m_keyChain(keyChain)
     , m_keyName(keyName)
     , m_face(face)
+    , m_scheduler(face.getIoService())
     , m_verifyToBeSignedCallback(verifyToBeSignedCallback)
     , m_verifySignRequestCallback(verifySignRequestCallback)
+    , m_lifetimeToken(std::make_shared<char>())
 {
   // generate default key randomly
   ndnBLSInit();
+  if (m_keyName.empty()) {
+    m_keyName = m_prefix;
+    m_keyName.append("KEY").appendTimestamp();
+  }
+  BLSSecretKey sk;
   auto begin = std::chrono::steady_clock::now();
-  blsSecretKeySetByCSPRNG(&m_sk);
+  blsSecretKeySetByCSPRNG(&sk);
   auto end = std::chrono::steady_clock::now();
   std::cout << "Signer generating key pair: "
             << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
             << "[µs]" << std::endl;
-  
-  blsGetPublicKey(&m_pk, &m_sk);
-  if (m_keyName.empty()) {
-    m_keyName = m_prefix;
-    m_keyName.append("KEY").appendTimestamp();
-  }
+  addKey(m_keyName, sk);
 
-  Name invocationPrefix = m_prefix;
-  invocationPrefix.append("mps").append("sign");
-  m_signRequestHandle = m_face.setInterestFilter(invocationPrefix,
-                                                 std::bind(&BLSSigner::onSignRequest, this, _2),
-                                                 nullptr, onRegisterFail);
+  // one registration serves the sign requests, static ECDH keys and results of all hosted keys
+  m_prefixHandle = m_face.registerPrefix(m_prefix, nullptr, onRegisterFail);
+  m_ecdhKeyHandle = m_face.setInterestFilter(InterestFilter(m_prefix, "<>*<mps><ecdh><>*"),
+                                             std::bind(&BLSSigner::onStaticEcdhKeyRequest, this, _2));
+  m_signRequestHandle = m_face.setInterestFilter(InterestFilter(m_prefix, "<>*<mps><sign><>*"),
+                                                 std::bind(&BLSSigner::onSignRequest, this, _2));
 }
 
 BLSSigner::~BLSSigner()
 {
-  m_signRequestHandle.unregister();
+  m_signRequestHandle.cancel();
+  m_ecdhKeyHandle.cancel();
+  m_prefixHandle.unregister();
+  for (auto& item : m_requests) {
+    item.second->m_resultPrefixHandle.cancel();
+  }
+}
+
+const BLSPublicKey&
+BLSSigner::addKey(const Name& keyName, const BLSSecretKey& sk)
+{
+  if (!m_prefix.isPrefixOf(keyName) || keyName.size() < m_prefix.size() + 2) {
+    NDN_THROW(std::runtime_error("Hosted key " + keyName.toUri() + " is not under " + m_prefix.toUri()));
+  }
+  // shares cached for a replaced key are not valid under the new one
+  m_signatureCache.eraseKey(keyName);
+  auto& key = m_keys[keyName];
+  key.m_keyName = keyName;
+  key.m_sk = sk;
+  blsGetPublicKey(&key.m_pk, &key.m_sk);
+  // a replaced key does not keep the static ECDH keys of the one before
+  key.m_staticEcdh.reset();
+  rotateStaticEcdhKey(key);
+  m_identityKeys[keyName.getPrefix(-2)] = keyName;
+  return key.m_pk;
+}
+
+void
+BLSSigner::rotateStaticEcdhKey(HostedKey& key)
+{
+  key.m_previousStaticEcdh = std::move(key.m_staticEcdh);
+  key.m_staticEcdh = m_ecdhKeyPool->acquire();
+
+  // publish the static ECDH key, signed with the BLS key so initiators can authenticate it
+  Name ecdhKeyPrefix = key.m_keyName.getPrefix(-2);
+  ecdhKeyPrefix.append("mps").append("ecdh");
+  key.m_staticEcdhKeyData = Data(Name(ecdhKeyPrefix).appendVersion());
+  Block ecdhKeyContent(ndn::tlv::Content);
+  const auto& staticPubKey = key.m_staticEcdh->getSelfPubKey();
+  ecdhKeyContent.push_back(makeBinaryBlock(tlv::EcdhPub, staticPubKey.data(), staticPubKey.size()));
+  ecdhKeyContent.encode();
+  key.m_staticEcdhKeyData.setContent(ecdhKeyContent);
+  key.m_staticEcdhKeyData.setFreshnessPeriod(STATIC_ECDH_KEY_FRESHNESS);
+  ndnBLSSign(key.m_sk, key.m_staticEcdhKeyData, key.m_keyName);
+
+  key.m_rotationEvent = m_scheduler.schedule(STATIC_ECDH_KEY_FRESHNESS, [this, keyName = key.m_keyName] {
+    auto it = m_keys.find(keyName);
+    if (it != m_keys.end()) {
+      rotateStaticEcdhKey(it->second);
+    }
+  });
+}
+
+const BLSPublicKey&
+BLSSigner::addKey(const Name& keyName)
+{
+  BLSSecretKey sk;
+  blsSecretKeySetByCSPRNG(&sk);
+  return addKey(keyName, sk);
+}
+
+bool
+BLSSigner::removeKey(const Name& keyName)
+{
+  if (keyName == m_keyName) {
+    NDN_THROW(std::runtime_error("Cannot remove the default key " + keyName.toUri()));
+  }
+  auto it = m_keys.find(keyName);
+  if (it == m_keys.end()) {
+    return false;
+  }
+  // drop the requests that would be signed by the key
+  std::vector<uint64_t> requestIds;
+  for (const auto& item : m_requests) {
+    if (item.second->m_keyName == keyName) {
+      requestIds.push_back(item.first);
+    }
+  }
+  for (auto requestId : requestIds) {
+    eraseRequest(requestId);
+  }
+  auto identityIt = m_identityKeys.find(keyName.getPrefix(-2));
+  if (identityIt != m_identityKeys.end() && identityIt->second == keyName) {
+    m_identityKeys.erase(identityIt);
+    for (const auto& item : m_keys) {
+      if (item.first != keyName && item.first.getPrefix(-2) == keyName.getPrefix(-2)) {
+        m_identityKeys[item.first.getPrefix(-2)] = item.first;
+      }
+    }
+  }
+  m_signatureCache.eraseKey(keyName);
+  m_keys.erase(it);
+  return true;
+}
+
+const HostedKey*
+BLSSigner::findTargetKey(const Interest& interest) const
+{
+  // the identity is the name before /mps/<verb>
+  const auto& name = interest.getName();
+  Name identity;
+  for (size_t i = name.size(); i > m_prefix.size(); i--) {
+    if (name.get(i - 1) == name::Component("mps")) {
+      identity = name.getPrefix(i - 1);
+      break;
+    }
+  }
+
+  Name keyName;
+  if (interest.hasApplicationParameters()) {
+    const auto& paramBlock = interest.getApplicationParameters();
+    paramBlock.parse();
+    auto keyNameIt = paramBlock.find(tlv::SignerKeyName);
+    if (keyNameIt != paramBlock.elements_end()) {
+      keyName = Name(keyNameIt->blockFromValue());
+    }
+  }
+  if (keyName.empty()) {
+    auto identityIt = m_identityKeys.find(identity);
+    if (identityIt == m_identityKeys.end()) {
+      return nullptr;
+    }
+    keyName = identityIt->second;
+  }
+  auto it = m_keys.find(keyName);
+  if (it == m_keys.end() || keyName.getPrefix(-2) != identity) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+void
+BLSSigner::onStaticEcdhKeyRequest(const Interest& interest)
+{
+  const HostedKey* key = findTargetKey(interest);
+  if (key == nullptr) {
+    NDN_LOG_INFO("No hosted key for " << interest.getName());
+    return;
+  }
+  m_face.put(key->m_staticEcdhKeyData);
+}
+
+std::shared_ptr<SignRequestState>
+BLSSigner::findRequest(uint64_t requestId) const
+{
+  auto it = m_requests.find(requestId);
+  if (it == m_requests.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+void
+BLSSigner::insertRequest(uint64_t requestId, const std::shared_ptr<SignRequestState>& state)
+{
+  // make room for the new request by evicting the oldest ones
+  while (!m_requestOrder.empty() &&
+         (m_requests.size() + 1 > m_limits.maxPendingRequests ||
+          m_counters.nPendingBytes + state->m_size > m_limits.maxPendingBytes)) {
+    NDN_LOG_INFO("Request table is full, evict request " << m_requestOrder.front());
+    eraseRequest(m_requestOrder.front());
+    m_counters.nEvictedRequests++;
+  }
+  state->m_requestId = requestId;
+  state->m_orderIt = m_requestOrder.insert(m_requestOrder.end(), requestId);
+  state->m_expiryEvent = m_scheduler.schedule(m_limits.requestLifetime, [this, requestId] {
+    NDN_LOG_DEBUG("Request " << requestId << " expired");
+    eraseRequest(requestId);
+    m_counters.nExpiredRequests++;
+  });
+  m_requests.emplace(requestId, state);
+  m_counters.nPendingRequests = m_requests.size();
+  m_counters.nPendingBytes += state->m_size;
+}
+
+bool
+BLSSigner::resizeRequest(const std::shared_ptr<SignRequestState>& state, size_t newSize)
+{
+  if (m_requests.count(state->m_requestId) == 0) {
+    state->m_size = newSize;
+    return true;
+  }
+  if (newSize > m_limits.maxPendingBytes) {
+    NDN_LOG_INFO("Request " << state->m_requestId << " of " << newSize << " bytes exceeds the byte limit");
+    return false;
+  }
+  m_counters.nPendingBytes = m_counters.nPendingBytes - state->m_size + newSize;
+  state->m_size = newSize;
+  // make room for the grown request by evicting the oldest other ones
+  auto it = m_requestOrder.begin();
+  while (m_counters.nPendingBytes > m_limits.maxPendingBytes && it != m_requestOrder.end()) {
+    auto requestId = *it++;
+    if (requestId == state->m_requestId) {
+      continue;
+    }
+    NDN_LOG_INFO("Request table is full, evict request " << requestId);
+    eraseRequest(requestId);
+    m_counters.nEvictedRequests++;
+  }
+  return true;
+}
+
+void
+BLSSigner::eraseRequest(uint64_t requestId)
+{
+  auto it = m_requests.find(requestId);
+  if (it == m_requests.end()) {
+    return;
+  }
+  auto state = it->second;
+  state->m_resultPrefixHandle.cancel();
+  state->m_expiryEvent.cancel();
+  state->m_holdEvent.cancel();
+  m_requestOrder.erase(state->m_orderIt);
+  m_counters.nPendingBytes -= state->m_size;
+  m_requests.erase(it);
+  m_counters.nPendingRequests = m_requests.size();
+}
+
+uint64_t
+BLSSigner::runPolicyCheck(const function<void(const PolicyDecisionCallback&)>& check,
+                          const PolicyDecisionCallback& onDecision)
+{
+  if (m_policyChecks.size() >= m_limits.maxPendingPolicyChecks) {
+    NDN_LOG_INFO("Too many pending policy checks, deny the request");
+    onDecision(false);
+    return 0;
+  }
+  auto checkId = ++m_lastPolicyCheckId;
+  auto& entry = m_policyChecks[checkId];
+  entry.m_onDecision = onDecision;
+  entry.m_timeoutEvent = m_scheduler.schedule(m_policyTimeout, [this, checkId] {
+    NDN_LOG_INFO("Policy check " << checkId << " timed out");
+    m_counters.nPolicyTimeouts++;
+    concludePolicyCheck(checkId, false);
+  });
+  m_counters.nPendingPolicyChecks = m_policyChecks.size();
+
+  // the decision may come from another thread, conclude it on the face's thread
+  std::weak_ptr<char> token = m_lifetimeToken;
+  auto& ioService = m_face.getIoService();
+  check([this, checkId, token, &ioService] (bool isAccepted) {
+    ioService.post([this, checkId, token, isAccepted] {
+      if (!token.expired()) {
+        concludePolicyCheck(checkId, isAccepted);
+      }
+    });
+  });
+  return checkId;
+}
+
+void
+BLSSigner::concludePolicyCheck(uint64_t checkId, bool isAccepted)
+{
+  auto it = m_policyChecks.find(checkId);
+  if (it == m_policyChecks.end()) {
+    // timed out or already decided
+    return;
+  }
+  auto onDecision = std::move(it->second.m_onDecision);
+  m_policyChecks.erase(it);
+  m_counters.nPendingPolicyChecks = m_policyChecks.size();
+  onDecision(isAccepted);
+}
+
+void
+BLSSigner::cancelPolicyCheck(uint64_t checkId)
+{
+  m_policyChecks.erase(checkId);
+  m_counters.nPendingPolicyChecks = m_policyChecks.size();
+}
+
+void
+BLSSigner::checkToBeSigned(const Data& unsignedData, const PolicyDecisionCallback& onDecision)
+{
+  if (!m_asyncVerifyToBeSignedCallback) {
+    onDecision(m_verifyToBeSignedCallback(unsignedData));
+    return;
+  }
+  runPolicyCheck([this, unsignedData] (const PolicyDecisionCallback& done) {
+                   m_asyncVerifyToBeSignedCallback(unsignedData, done);
+                 },
+                 onDecision);
+}
+
+void
+BLSSigner::checkToBeSignedBatch(const std::vector<Data>& batch, const PolicyDecisionCallback& onDecision)
+{
+  if (batch.empty()) {
+    onDecision(false);
+    return;
+  }
+  if (!m_asyncVerifyToBeSignedCallback) {
+    onDecision(std::all_of(batch.begin(), batch.end(),
+                           [this] (const Data& unsignedData) { return m_verifyToBeSignedCallback(unsignedData); }));
+    return;
+  }
+  // admit all the checks of the batch, or none
+  if (m_policyChecks.size() + batch.size() > m_limits.maxPendingPolicyChecks) {
+    NDN_LOG_INFO("Too many pending policy checks, deny the batch of " << batch.size());
+    onDecision(false);
+    return;
+  }
+  // the first rejection, or the last acceptance, decides, and the checks still pending are dropped
+  auto nPending = std::make_shared<size_t>(batch.size());
+  auto checkIds = std::make_shared<std::vector<uint64_t>>();
+  for (const auto& unsignedData : batch) {
+    checkIds->push_back(runPolicyCheck([this, unsignedData] (const PolicyDecisionCallback& done) {
+                                         m_asyncVerifyToBeSignedCallback(unsignedData, done);
+                                       },
+                                       [this, nPending, checkIds, onDecision] (bool isAccepted) {
+                                         if (isAccepted && --*nPending > 0) {
+                                           return;
+                                         }
+                                         for (auto checkId : *checkIds) {
+                                           cancelPolicyCheck(checkId);
+                                         }
+                                         onDecision(isAccepted);
+                                       }));
+  }
+}
+
+void
+BLSSigner::rejectOverloaded(const Interest& interest, const HostedKey& key, time::milliseconds retryAfter)
+{
+  NDN_LOG_INFO("Reject sign request " << interest.getName() << ", retry after " << retryAfter);
+  m_counters.nRejectedRequests++;
+  auto reply = generateUnavailableReply(interest.getName(), retryAfter);
+  ndnBLSSign(key.m_sk, reply, key.m_keyName);
+  m_face.put(reply);
+}
+
+void
+BLSSigner::onResultRequest(uint64_t requestId, const Interest& interest)
+{
+  std::cout << "\n\nSigner: received result fetch Interest: " << interest.getName().toUri() << std::endl;
+  // parse request: /signer/mps/result/randomness/version/hash
+  if (interest.getName().size() != m_prefix.size() + 5) {
+    NDN_LOG_INFO("Bad result request name format");
+    return;
+  }
+  auto statePtr = findRequest(requestId);
+  if (statePtr == nullptr) {
+    NDN_LOG_INFO("Result requested for an unknown or expired request " << requestId);
+    return;
+  }
+  if (!verifyInterestWithHmac(interest, statePtr->m_hmacKey.data(), statePtr->m_hmacKey.size())) {
+    NDN_LOG_INFO("HMAC verification of the result request failed");
+    return;
+  }
+  if (statePtr->m_code != ReplyCode::Processing || m_longPollHold <= time::milliseconds(0)) {
+    replyResult(statePtr, interest.getName());
+    return;
+  }
+  // long-poll: hold the Interest until the result is ready, but answer before it expires
+  auto hold = std::min(m_longPollHold, interest.getInterestLifetime() - LONG_POLL_MARGIN);
+  if (hold <= time::milliseconds(0)) {
+    replyResult(statePtr, interest.getName());
+    return;
+  }
+  // one Interest is held per request: a retransmission releases the one held before with Processing (102)
+  answerHeldResultInterest(statePtr);
+  statePtr->m_heldResultName = interest.getName();
+  statePtr->m_holdEvent = m_scheduler.schedule(hold, [this, requestId] {
+    auto statePtr = findRequest(requestId);
+    if (statePtr != nullptr) {
+      answerHeldResultInterest(statePtr);
+    }
+  });
+}
+
+void
+BLSSigner::answerHeldResultInterest(const std::shared_ptr<SignRequestState>& statePtr)
+{
+  if (statePtr->m_heldResultName.empty()) {
+    return;
+  }
+  Name interestName = statePtr->m_heldResultName;
+  statePtr->m_heldResultName.clear();
+  statePtr->m_holdEvent.cancel();
+  replyResult(statePtr, interestName);
+}
+
+void
+BLSSigner::replyResult(const std::shared_ptr<SignRequestState>& statePtr, const Name& interestName)
+{
+  auto result = generateResultData(interestName, statePtr->m_resultPrefix, statePtr, getResultAfter());
+  signDataWithHmac(result, statePtr->m_hmacKey.data(), statePtr->m_hmacKey.size(), statePtr->m_resultPrefix);
+  m_face.put(result);
+  if (statePtr->m_code != ReplyCode::Processing) {
+    eraseRequest(statePtr->m_requestId);
+  }
+}
+
+time::milliseconds
+BLSSigner::getResultAfter() const
+{
+  return m_longPollHold > time::milliseconds(0) ? time::milliseconds(0) : ESTIMATE_PROCESS_TIME;
+}
+
+void
+BLSSigner::onInlineSignRequest(const Interest& interest, const HostedKey& key)
+{
+  // parse: EcdhPub, Salt and the encrypted unsigned Data
+  std::array<uint8_t, 48> aesAndHmac;
+  Data unsignedData;
+  bool isDecoded = true;
+  try {
+    const auto& paramBlock = interest.getApplicationParameters();
+    const auto& ecdhBlock = paramBlock.get(tlv::EcdhPub);
+    std::vector<uint8_t> peerPubKey(ecdhBlock.value(), ecdhBlock.value() + ecdhBlock.value_size());
+    const auto& saltBlock = paramBlock.get(tlv::Salt);
+    // the request may be encrypted to the static key replaced last
+    Buffer decrypted;
+    bool isDecrypted = false;
+    for (const auto* staticEcdh : {key.m_staticEcdh.get(), key.m_previousStaticEcdh.get()}) {
+      if (staticEcdh == nullptr || isDecrypted) {
+        continue;
+      }
+      try {
+        auto dhSecret = staticEcdh->deriveSecret(peerPubKey);
+        hkdf(dhSecret.data(), dhSecret.size(), saltBlock.value(), saltBlock.value_size(),
+             aesAndHmac.data(), aesAndHmac.size());
+        decrypted = decodeBlockWithAesGcm128(paramBlock.get(tlv::InlineParameter), aesAndHmac.data(), nullptr, 0);
+        isDecrypted = true;
+      }
+      catch (const std::exception& e) {
+        NDN_LOG_DEBUG("Cannot decrypt the inline sign request with a static key: " << e.what());
+      }
+    }
+    if (!isDecrypted) {
+      NDN_THROW(std::runtime_error("Not encrypted to a current static ECDH key"));
+    }
+    unsignedData.wireDecode(Block(std::make_shared<Buffer>(std::move(decrypted))));
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_ERROR("Inline sign request decoding error: " << e.what());
+    isDecoded = false;
+  }
+  if (!isDecoded || m_delegatedSignCallback) {
+    // delegated shares are not ready in one round trip either, the initiator falls back to the full protocol
+    auto reply = generateSignRequestAck(interest.getName(), m_prefix, ReplyCode::BadRequest);
+    ndnBLSSign(key.m_sk, reply, key.m_keyName);
+    m_face.put(reply);
+    return;
+  }
+  checkToBeSigned(unsignedData, [this, interest, unsignedData, aesAndHmac, keyName = key.m_keyName] (bool isAccepted) {
+    auto keyIt = m_keys.find(keyName);
+    if (keyIt == m_keys.end()) {
+      NDN_LOG_ERROR("Key " << keyName << " has been removed");
+      return;
+    }
+    replyInlineSignRequest(interest, keyIt->second, unsignedData, aesAndHmac, isAccepted);
+  });
+}
+
+void
+BLSSigner::replyInlineSignRequest(const Interest& interest, const HostedKey& key, const Data& unsignedData,
+                                  const std::array<uint8_t, 48>& aesAndHmac, bool isAccepted)
+{
+  if (!isAccepted) {
+    NDN_LOG_ERROR("Unsigned Data verification error");
+    auto reply = generateSignRequestAck(interest.getName(), m_prefix, ReplyCode::Unauthorized);
+    ndnBLSSign(key.m_sk, reply, key.m_keyName);
+    m_face.put(reply);
+    return;
+  }
+  auto signatureValue = generateSignature(key, unsignedData);
+
+  // reply with the encrypted signature share in the same round trip
+  Block unencryptedBlock(tlv::EncryptedPayload);
+  unencryptedBlock.push_back(makeBinaryBlock(tlv::BLSSigValue, signatureValue.data(), signatureValue.size()));
+  unencryptedBlock.encode();
+  auto encryptedBlock = encodeBlockWithAesGcm128(ndn::tlv::Content, aesAndHmac.data(),
+                                                 unencryptedBlock.value(), unencryptedBlock.value_size(),
+                                                 nullptr, 0);
+  encryptedBlock.push_back(makeStringBlock(tlv::Status, std::to_string(static_cast<int>(ReplyCode::OK))));
+  encryptedBlock.encode();
+  Data reply(interest.getName());
+  reply.setContent(encryptedBlock);
+  reply.setFreshnessPeriod(TIMEOUT);
+  signDataWithHmac(reply, aesAndHmac.data() + 16, 32, key.m_keyName);
+  m_face.put(reply);
+}
+
+Buffer
+BLSSigner::generateSignature(const HostedKey& key, const Data& unsignedData)
+{
+  auto digest = computeSignedPortionDigest(unsignedData);
+  auto cached = m_signatureCache.find(key.m_keyName, digest);
+  if (cached != nullptr) {
+    NDN_LOG_DEBUG("Signature cache hit for " << unsignedData.getName());
+    return *cached;
+  }
+  auto signatureValue = ndnGenBLSSignature(key.m_sk, unsignedData);
+  m_signatureCache.insert(key.m_keyName, digest, signatureValue);
+  return signatureValue;
 }
 
 void
@@ -170,66 +777,172 @@ BLSSigner::onSignRequest(const Interest& interest)
 {
   std::cout << "\n\nSigner: On sign request Interest: " << interest.getName().toUri() << std::endl;
 
-  if (!m_verifySignRequestCallback(interest) || !interest.isParametersDigestValid()) {
+  if (!interest.isParametersDigestValid()) {
+    onSignRequestDecision(interest, false);
+    return;
+  }
+  const HostedKey* keyPtr = nullptr;
+  try {
+    keyPtr = findTargetKey(interest);
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_ERROR("Bad sign request parameters: " << e.what());
+  }
+  // admission control before the policy check: the rate of an initiator seen before, then the queue limits.
+  // The requester is not authenticated yet, so no bucket is created for it here.
+  if (keyPtr != nullptr) {
+    auto retryAfter = m_initiatorBuckets.getWaitTime(getRequesterKeyName(interest));
+    if (retryAfter > time::milliseconds(0)) {
+      rejectOverloaded(interest, *keyPtr, retryAfter);
+      return;
+    }
+    if (m_limits.maxQueuedRequests > 0 &&
+        m_requests.size() + m_policyChecks.size() >= m_limits.maxQueuedRequests) {
+      rejectOverloaded(interest, *keyPtr, ESTIMATE_PROCESS_TIME);
+      return;
+    }
+    if (m_asyncVerifySignRequestCallback && m_policyChecks.size() >= m_limits.maxPendingPolicyChecks) {
+      rejectOverloaded(interest, *keyPtr, ESTIMATE_PROCESS_TIME);
+      return;
+    }
+  }
+  if (!m_asyncVerifySignRequestCallback) {
+    onSignRequestDecision(interest, m_verifySignRequestCallback(interest));
+    return;
+  }
+  runPolicyCheck([this, interest] (const PolicyDecisionCallback& done) {
+                   m_asyncVerifySignRequestCallback(interest, done);
+                 },
+                 [this, interest] (bool isAccepted) { onSignRequestDecision(interest, isAccepted); });
+}
+
+void
+BLSSigner::onSignRequestDecision(const Interest& interest, bool isAccepted)
+{
+  const auto& defaultKey = m_keys.at(m_keyName);
+  // route to the hosted key
+  const HostedKey* keyPtr = nullptr;
+  try {
+    keyPtr = findTargetKey(interest);
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_ERROR("Bad sign request parameters: " << e.what());
+  }
+  if (!isAccepted) {
+    // signed by the requested key when there is one, which is the key an inline initiator checks
+    const auto& replyKey = keyPtr != nullptr ? *keyPtr : defaultKey;
     auto ack = generateSignRequestAck(interest.getName(), m_prefix, ReplyCode::Unauthorized);
-    ndnBLSSign(m_sk, ack, m_keyName);
+    ndnBLSSign(replyKey.m_sk, ack, replyKey.m_keyName);
+    m_face.put(ack);
+    return;
+  }
+  if (keyPtr == nullptr) {
+    NDN_LOG_INFO("No hosted key for " << interest.getName());
+    auto ack = generateSignRequestAck(interest.getName(), m_prefix, ReplyCode::NotFound);
+    ndnBLSSign(defaultKey.m_sk, ack, defaultKey.m_keyName);
     m_face.put(ack);
     return;
   }
+  const HostedKey& key = *keyPtr;
+  // charge the rate of the initiator, now that the policy accepted it, then check the global queue limit again
+  auto retryAfter = m_initiatorBuckets.tryAcquire(getRequesterKeyName(interest));
+  if (retryAfter > time::milliseconds(0)) {
+    rejectOverloaded(interest, key, retryAfter);
+    return;
+  }
+  const auto& paramBlock = interest.getApplicationParameters();
+  if (paramBlock.find(tlv::InlineParameter) != paramBlock.elements_end()) {
+    onInlineSignRequest(interest, key);
+    return;
+  }
+  if (m_limits.maxQueuedRequests > 0 && m_requests.size() >= m_limits.maxQueuedRequests) {
+    rejectOverloaded(interest, key, ESTIMATE_PROCESS_TIME);
+    return;
+  }
   // parse
   Name parameterDataName;
+  Name groupParameterName;
   std::vector<uint8_t> peerPubKey;
+  uint64_t sessionId = 0;
+  std::array<uint8_t, 32> nonce;
   try {
-    parseSignRequestPayload(interest, parameterDataName, peerPubKey);
+    parseSignRequestPayload(interest, parameterDataName, groupParameterName, peerPubKey, sessionId, nonce);
   }
   catch (const std::exception& e) {
     auto ack = generateSignRequestAck(interest.getName(), m_prefix,ReplyCode::Unauthorized);
-    ndnBLSSign(m_sk, ack, m_keyName);
+    ndnBLSSign(key.m_sk, ack, key.m_keyName);
     m_face.put(ack);
     return;
   }
+  // a resumed session must be known and belong to the same initiator
+  const ResumableSession* session = nullptr;
+  if (peerPubKey.empty()) {
+    session = m_sessionCache.find(sessionId);
+    if (session == nullptr || session->m_peer != getRequesterKeyName(interest)) {
+      NDN_LOG_INFO("Unknown or expired session " << sessionId);
+      auto ack = generateSignRequestAck(interest.getName(), m_prefix, ReplyCode::NotFound);
+      ndnBLSSign(key.m_sk, ack, key.m_keyName);
+      m_face.put(ack);
+      return;
+    }
+  }
   // generate state for the request
   auto statePtr = std::make_shared<SignRequestState>();
   statePtr->m_code = ReplyCode::Processing;
   statePtr->m_version = 0;
-  // ECDH
-  auto dhSecret = statePtr->m_ecdh.deriveSecret(peerPubKey);
+  statePtr->m_keyName = key.m_keyName;
+  statePtr->m_groupParameterName = groupParameterName;
+  statePtr->m_size = sizeof(SignRequestState) + interest.wireEncode().size();
+  // AES key, HMAC key and, for a full handshake, the session secret
+  std::array<uint8_t, 80> keyMaterial;
   std::array<uint8_t, 32> salt;
-  random::generateSecureBytes(salt.data(), salt.size());
-  std::array<uint8_t, 48> aesAndHmac;
-  hkdf(dhSecret.data(), dhSecret.size(), salt.data(), salt.size(), aesAndHmac.data(), aesAndHmac.size());
-  std::memcpy(statePtr->m_aesKey.data(), aesAndHmac.data(), 16);
-  auto hmacKeyStr = base64EncodeFromBytes(aesAndHmac.data() + 16, 32, false);
-  // HMAC
-  statePtr->m_hmacSigningInfo.setSigningHmacKey(hmacKeyStr);
-  statePtr->m_hmacSigningInfo.setDigestAlgorithm(DigestAlgorithm::SHA256);
-  statePtr->m_hmacSigningInfo.setSignedInterestFormat(security::SignedInterestFormat::V03);
+  ResumableSession newSession;
+  if (session != nullptr) {
+    // derive the request keys from the session secret, skip ECDH
+    hkdf(session->m_secret.data(), session->m_secret.size(), nonce.data(), nonce.size(), keyMaterial.data(), 48);
+  }
+  else {
+    // ECDH
+    statePtr->m_ecdh = m_ecdhKeyPool->acquire();
+    auto dhSecret = statePtr->m_ecdh->deriveSecret(peerPubKey);
+    random::generateSecureBytes(salt.data(), salt.size());
+    hkdf(dhSecret.data(), dhSecret.size(), salt.data(), salt.size(), keyMaterial.data(), keyMaterial.size());
+    if (m_sessionCache.isEnabled()) {
+      newSession.m_id = random::generateSecureWord64();
+      std::memcpy(newSession.m_secret.data(), keyMaterial.data() + 48, newSession.m_secret.size());
+      newSession.m_peer = getRequesterKeyName(interest);
+      newSession.m_expiry = time::steady_clock::now() + m_sessionCache.getLifetime();
+      m_sessionCache.insert(newSession);
+    }
+  }
+  std::memcpy(statePtr->m_aesKey.data(), keyMaterial.data(), 16);
+  std::memcpy(statePtr->m_hmacKey.data(), keyMaterial.data() + 16, 32);
 
   auto requestId = random::generateSecureWord64();
   Name resultPrefix = m_prefix;
   resultPrefix.append("mps").append("result").appendNumber(requestId);
+  statePtr->m_resultPrefix = resultPrefix;
+  // covered by the registration of m_prefix
   statePtr->m_resultPrefixHandle = m_face.setInterestFilter(
-    resultPrefix,
-    [this, statePtr, resultPrefix](const auto&, const auto& interest)
-    {
-      std::cout << "\n\nSigner: received result fetch Interest: " << interest.getName().toUri() << std::endl;
-      // parse request: /signer/mps/result/randomness/version/hash
-      // TODO: signature verification
-      if (interest.getName().size() != m_prefix.size() + 5) {
-        NDN_LOG_INFO("Bad result request name format");
-        return;
-      }
-      auto result = generateResultData(interest.getName(), resultPrefix, statePtr);
-      m_keyChain.sign(result, statePtr->m_hmacSigningInfo);
-      m_face.put(result);
-    },
-    nullptr, onRegisterFail);
+    InterestFilter(resultPrefix),
+    [this, requestId](const auto&, const auto& interest) { onResultRequest(requestId, interest); });
+  insertRequest(requestId, statePtr);
 
-  auto selfPubKey = statePtr->m_ecdh.getSelfPubKey();
-  auto ack = generateSignRequestAck(interest.getName(), m_prefix, ReplyCode::Processing, requestId,
-                                    salt.data(), selfPubKey.data(), selfPubKey.size(), statePtr->m_aesKey.data());
-  ndnBLSSign(m_sk, ack, m_keyName);
+  Data ack;
+  if (session != nullptr) {
+    ack = generateSignRequestAck(interest.getName(), m_prefix, ReplyCode::Processing, requestId,
+                                 nullptr, nullptr, 0, statePtr->m_aesKey.data(),
+                                 0, time::milliseconds(0), getResultAfter());
+  }
+  else {
+    auto selfPubKey = statePtr->m_ecdh->getSelfPubKey();
+    ack = generateSignRequestAck(interest.getName(), m_prefix, ReplyCode::Processing, requestId,
+                                 salt.data(), selfPubKey.data(), selfPubKey.size(), statePtr->m_aesKey.data(),
+                                 newSession.m_id, m_sessionCache.getLifetime(), getResultAfter());
+  }
+  ndnBLSSign(key.m_sk, ack, key.m_keyName);
   m_face.put(ack);
+  statePtr->m_ackTime = time::steady_clock::now();
 
   // fetch parameter
   Interest fetchInterest(parameterDataName);
@@ -242,48 +955,213 @@ BLSSigner::onSignRequest(const Interest& interest)
     [=](const auto& interest, const auto& data)
     {
       std::cout << "\n\nSigner: fetched parameter Data packet." << std::endl << data;
-      if (!security::verifySignature(data, m_keyChain.getTpm(),
-                                    statePtr->m_hmacSigningInfo.getSignerName(),
-                                    DigestAlgorithm::SHA256)) {
+      auto statePtr = findRequest(requestId);
+      if (statePtr == nullptr) {
+        NDN_LOG_INFO("Parameter fetched for an evicted request " << requestId);
+        return;
+      }
+      if (!verifyDataWithHmac(data, statePtr->m_hmacKey.data(), statePtr->m_hmacKey.size())) {
         std::cout << "Signer: HMAC verification failed" << std::endl;
         return;
       }
-      Data unsignedData;
+      std::vector<Data> batch;
       try {
-        unsignedData = parseParameterData(data, statePtr);
+        auto parameterBlock = parseParameterData(data, statePtr);
+        if (parameterBlock.type() == tlv::GroupContentKey) {
+          if (statePtr->m_groupParameterName.empty() || parameterBlock.value_size() != statePtr->m_contentKey.size()) {
+            NDN_THROW(std::runtime_error("Unexpected group content key"));
+          }
+          std::memcpy(statePtr->m_contentKey.data(), parameterBlock.value(), statePtr->m_contentKey.size());
+          statePtr->m_hasContentKey = true;
+        }
+        else {
+          batch = decodeParameterBatch(parameterBlock);
+        }
       }
       catch (const std::exception& e) {
         NDN_LOG_ERROR("Unsigned Data decoding error");
         statePtr->m_code = ReplyCode::FailedDependency;
+        answerHeldResultInterest(statePtr);
         return;
       }
-      if (!m_verifyToBeSignedCallback(unsignedData)) {
-        NDN_LOG_ERROR("Unsigned Data verification error");
-        statePtr->m_code = ReplyCode::Unauthorized;
+      if (statePtr->m_hasContentKey) {
+        onGroupParameterPart(requestId);
         return;
       }
-      // generate result
-      std::cout << "Signer: result status code is OK " << std::endl;
-      statePtr->m_code = ReplyCode::OK;
-      auto begin = std::chrono::steady_clock::now();
-      statePtr->m_signatureValue = ndnGenBLSSignature(m_sk, unsignedData);
-      auto end = std::chrono::steady_clock::now();
-      std::cout << "Signer generating signature piece: "
-                << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
-                << "[µs]" << std::endl;
-      std::cout << "signature value length: " << statePtr->m_signatureValue.size() << std::endl;
+      checkToBeSignedBatch(batch, [this, requestId, batch] (bool isAccepted) {
+        onToBeSignedDecision(requestId, batch, isAccepted);
+      });
     },
     [=](auto& interest, auto&)
     {
       // nack
-      statePtr->m_code = ReplyCode::FailedDependency;
+      auto statePtr = findRequest(requestId);
+      if (statePtr != nullptr) {
+        statePtr->m_code = ReplyCode::FailedDependency;
+        answerHeldResultInterest(statePtr);
+      }
     },
     [=](auto& interest)
     {
       // timeout
-      statePtr->m_code = ReplyCode::FailedDependency;
+      auto statePtr = findRequest(requestId);
+      if (statePtr != nullptr) {
+        statePtr->m_code = ReplyCode::FailedDependency;
+        answerHeldResultInterest(statePtr);
+      }
+    });
+
+  // group mode: fetch the shared parameter Data in parallel, by its full name so that any cache can answer
+  if (!groupParameterName.empty()) {
+    Interest groupInterest(groupParameterName);
+    groupInterest.setCanBePrefix(false);
+    groupInterest.setInterestLifetime(TIMEOUT);
+    m_face.expressInterest(
+      groupInterest,
+      [=](const auto&, const auto& data)
+      {
+        auto statePtr = findRequest(requestId);
+        if (statePtr == nullptr) {
+          return;
+        }
+        if (!resizeRequest(statePtr, statePtr->m_size + data.wireEncode().size())) {
+          statePtr->m_code = ReplyCode::Unavailable;
+          answerHeldResultInterest(statePtr);
+          return;
+        }
+        statePtr->m_groupParameterData = data;
+        statePtr->m_hasGroupParameterData = true;
+        onGroupParameterPart(requestId);
+      },
+      [=](auto&, auto&)
+      {
+        auto statePtr = findRequest(requestId);
+        if (statePtr != nullptr) {
+          statePtr->m_code = ReplyCode::FailedDependency;
+          answerHeldResultInterest(statePtr);
+        }
+      },
+      [=](auto&)
+      {
+        auto statePtr = findRequest(requestId);
+        if (statePtr != nullptr) {
+          statePtr->m_code = ReplyCode::FailedDependency;
+          answerHeldResultInterest(statePtr);
+        }
+      });
+  }
+}
+
+void
+BLSSigner::onGroupParameterPart(uint64_t requestId)
+{
+  auto statePtr = findRequest(requestId);
+  if (statePtr == nullptr || !statePtr->m_hasContentKey || !statePtr->m_hasGroupParameterData ||
+      statePtr->m_code != ReplyCode::Processing) {
+    return;
+  }
+  std::vector<Data> batch;
+  try {
+    const auto& contentBlock = statePtr->m_groupParameterData.getContent();
+    contentBlock.parse();
+    batch = decodeParameterBatch(Block(std::make_shared<Buffer>(
+      decodeBlockWithAesGcm128(contentBlock, statePtr->m_contentKey.data(), nullptr, 0))));
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_ERROR("Group parameter decoding error: " << e.what());
+    statePtr->m_code = ReplyCode::FailedDependency;
+    answerHeldResultInterest(statePtr);
+    return;
+  }
+  checkToBeSignedBatch(batch, [this, requestId, batch] (bool isAccepted) {
+    onToBeSignedDecision(requestId, batch, isAccepted);
+  });
+}
+
+void
+BLSSigner::onToBeSignedDecision(uint64_t requestId, const std::vector<Data>& batch, bool isAccepted)
+{
+  auto statePtr = findRequest(requestId);
+  if (statePtr == nullptr) {
+    NDN_LOG_INFO("Policy decided for an evicted request " << requestId);
+    return;
+  }
+  if (!isAccepted) {
+    NDN_LOG_ERROR("Unsigned Data verification error");
+    statePtr->m_code = ReplyCode::Unauthorized;
+    answerHeldResultInterest(statePtr);
+    return;
+  }
+  auto keyIt = m_keys.find(statePtr->m_keyName);
+  if (keyIt == m_keys.end()) {
+    NDN_LOG_ERROR("Key " << statePtr->m_keyName << " has been removed");
+    statePtr->m_code = ReplyCode::NotFound;
+    answerHeldResultInterest(statePtr);
+    return;
+  }
+  if (m_delegatedSignCallback) {
+    std::weak_ptr<char> lifetimeToken = m_lifetimeToken;
+    m_delegatedSignCallback(batch, [this, lifetimeToken, requestId, batchSize = batch.size()]
+                                   (const std::vector<Buffer>& shares, const MpsSignerList& signers) {
+      if (lifetimeToken.expired()) {
+        return;
+      }
+      onDelegatedShares(requestId, batchSize, shares, signers);
     });
+    return;
+  }
+  // generate result
+  std::cout << "Signer: result status code is OK " << std::endl;
+  statePtr->m_code = ReplyCode::OK;
+  statePtr->m_serviceTime = time::duration_cast<time::milliseconds>(time::steady_clock::now() - statePtr->m_ackTime);
+  auto begin = std::chrono::steady_clock::now();
+  size_t signaturesSize = 0;
+  statePtr->m_signatureValues.clear();
+  for (const auto& unsignedData : batch) {
+    statePtr->m_signatureValues.push_back(generateSignature(keyIt->second, unsignedData));
+    signaturesSize += statePtr->m_signatureValues.back().size();
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "Signer generating signature pieces of size " << batch.size() << ": "
+            << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
+            << "[µs]" << std::endl;
+  if (!resizeRequest(statePtr, statePtr->m_size + signaturesSize)) {
+    statePtr->m_code = ReplyCode::Unavailable;
+    statePtr->m_signatureValues.clear();
+  }
+  answerHeldResultInterest(statePtr);
+}
+
+void
+BLSSigner::onDelegatedShares(uint64_t requestId, size_t batchSize,
+                             const std::vector<Buffer>& shares, const MpsSignerList& signers)
+{
+  auto statePtr = findRequest(requestId);
+  if (statePtr == nullptr) {
+    NDN_LOG_INFO("Delegated signing finished for an evicted request " << requestId);
+    return;
+  }
+  if (shares.size() != batchSize || signers.m_signers.empty()) {
+    NDN_LOG_ERROR("Delegated signing failed for request " << requestId);
+    statePtr->m_code = ReplyCode::FailedDependency;
+    answerHeldResultInterest(statePtr);
+    return;
+  }
+  size_t resultSize = signers.wireEncode().size();
+  for (const auto& share : shares) {
+    resultSize += share.size();
+  }
+  if (!resizeRequest(statePtr, statePtr->m_size + resultSize)) {
+    statePtr->m_code = ReplyCode::Unavailable;
+    answerHeldResultInterest(statePtr);
+    return;
+  }
+  statePtr->m_code = ReplyCode::OK;
+  statePtr->m_serviceTime = time::duration_cast<time::milliseconds>(time::steady_clock::now() - statePtr->m_ackTime);
+  statePtr->m_signatureValues = shares;
+  statePtr->m_contributors = signers;
+  answerHeldResultInterest(statePtr);
 }
 
 }  // namespace mps
-}  // namespace ndn
\ No newline at end of file
+}  // namespace ndn
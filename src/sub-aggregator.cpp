@@ -0,0 +1,41 @@
+#include "ndnmps/sub-aggregator.hpp"
+#include <ndn-cxx/util/logger.hpp>
+
+namespace ndn {
+namespace mps {
+
+NDN_LOG_INIT(ndnmps.subaggregator);
+
+SubAggregator::SubAggregator(const Name& prefix, Face& face, KeyChain& keyChain, Scheduler& scheduler,
+                             const Name& keyName, const Name& signingKeyName, const MultipartySchema& subtreeSchema)
+  : m_signer(prefix, face, keyChain, keyName)
+  , m_initiator(prefix, keyChain, face, scheduler)
+  , m_subtreeSchema(subtreeSchema)
+  , m_signingKeyName(signingKeyName)
+{
+  // the subtree must answer before the parent's request expires at this node
+  m_initiator.setSessionDeadline(m_signer.getLimits().requestLifetime);
+  m_signer.setDelegatedSignCallback(std::bind(&SubAggregator::aggregate, this, _1, _2));
+}
+
+void
+SubAggregator::aggregate(const std::vector<Data>& batch, const DelegatedSignCompletion& onShares)
+{
+  try {
+    m_initiator.aggregatePartial(batch, m_subtreeSchema, m_signingKeyName,
+                                 [onShares] (const std::vector<Buffer>& aggregates, const MpsSignerList& signers) {
+                                   onShares(aggregates, signers);
+                                 },
+                                 [onShares] (const std::string& reason) {
+                                   NDN_LOG_ERROR("Subtree aggregation failed: " << reason);
+                                   onShares({}, MpsSignerList());
+                                 });
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_ERROR("Subtree aggregation failed: " << e.what());
+    onShares({}, MpsSignerList());
+  }
+}
+
+}  // namespace mps
+}  // namespace ndn
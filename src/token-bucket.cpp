@@ -0,0 +1,93 @@
+#include "ndnmps/token-bucket.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ndn {
+namespace mps {
+
+TokenBucketTable::TokenBucketTable(double rate, double burst, size_t capacity)
+  : m_rate(rate)
+  , m_burst(burst)
+  , m_capacity(capacity)
+{
+}
+
+void
+TokenBucketTable::setRate(double rate, double burst)
+{
+  m_rate = rate;
+  m_burst = burst;
+  m_buckets.clear();
+}
+
+time::milliseconds
+TokenBucketTable::tryAcquire(const Name& peer)
+{
+  if (!isEnabled()) {
+    return time::milliseconds(0);
+  }
+  auto now = time::steady_clock::now();
+  auto it = m_buckets.find(peer);
+  if (it == m_buckets.end()) {
+    if (m_buckets.size() >= m_capacity) {
+      removeFullBuckets(now);
+    }
+    if (m_buckets.size() >= m_capacity) {
+      // every bucket is in use, the new peer shares the fate of an unknown one
+      return time::milliseconds(static_cast<time::milliseconds::rep>(std::ceil(1000 / m_rate)));
+    }
+    it = m_buckets.emplace(peer, Bucket{m_burst, now}).first;
+  }
+  auto& bucket = it->second;
+  refill(bucket, now);
+  if (bucket.m_tokens >= 1) {
+    bucket.m_tokens -= 1;
+    return time::milliseconds(0);
+  }
+  auto wait = std::ceil((1 - bucket.m_tokens) * 1000 / m_rate);
+  return time::milliseconds(std::max<time::milliseconds::rep>(static_cast<time::milliseconds::rep>(wait), 1));
+}
+
+time::milliseconds
+TokenBucketTable::getWaitTime(const Name& peer) const
+{
+  if (!isEnabled()) {
+    return time::milliseconds(0);
+  }
+  auto it = m_buckets.find(peer);
+  if (it == m_buckets.end()) {
+    return time::milliseconds(0);
+  }
+  auto bucket = it->second;
+  refill(bucket, time::steady_clock::now());
+  if (bucket.m_tokens >= 1) {
+    return time::milliseconds(0);
+  }
+  auto wait = std::ceil((1 - bucket.m_tokens) * 1000 / m_rate);
+  return time::milliseconds(std::max<time::milliseconds::rep>(static_cast<time::milliseconds::rep>(wait), 1));
+}
+
+void
+TokenBucketTable::refill(Bucket& bucket, time::steady_clock::TimePoint now) const
+{
+  auto elapsed = time::duration_cast<time::microseconds>(now - bucket.m_lastRefill).count() / 1000000.0;
+  bucket.m_tokens = std::min(m_burst, bucket.m_tokens + elapsed * m_rate);
+  bucket.m_lastRefill = now;
+}
+
+void
+TokenBucketTable::removeFullBuckets(time::steady_clock::TimePoint now)
+{
+  for (auto it = m_buckets.begin(); it != m_buckets.end();) {
+    refill(it->second, now);
+    if (it->second.m_tokens >= m_burst) {
+      it = m_buckets.erase(it);
+    }
+    else {
+      it++;
+    }
+  }
+}
+
+}  // namespace mps
+}  // namespace ndn
@@ -0,0 +1,131 @@
+#include "ndnmps/verifier-engine.hpp"
+#include <ndn-cxx/util/logger.hpp>
+#include <algorithm>
+
+namespace ndn {
+namespace mps {
+
+NDN_LOG_INIT(ndnmps.verifierengine);
+
+VerifierEngine::VerifierEngine(boost::asio::io_service& io, size_t nThreads)
+  : m_io(io)
+  , m_schema(std::make_shared<const MultipartySchemaContainer>())
+  , m_lifetimeToken(std::make_shared<char>())
+{
+  ndnBLSInit();
+  nThreads = std::max<size_t>(nThreads, 1);
+  for (size_t i = 0; i < nThreads; i++) {
+    m_queues.push_back(std::make_unique<TaskQueue>());
+  }
+  for (size_t i = 0; i < nThreads; i++) {
+    m_threads.emplace_back(&VerifierEngine::runWorker, this, i);
+  }
+}
+
+VerifierEngine::~VerifierEngine()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_idleMutex);
+    m_isStopped = true;
+  }
+  m_idleCondition.notify_all();
+  for (auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+void
+VerifierEngine::setSchemaContainer(const MultipartySchemaContainer& container)
+{
+  std::atomic_store(&m_schema, std::shared_ptr<const MultipartySchemaContainer>(
+                                 std::make_shared<MultipartySchemaContainer>(container)));
+}
+
+void
+VerifierEngine::verify(const Data& data, const MpsSignerList& signerList, const function<void(bool)>& callback)
+{
+  std::weak_ptr<char> token = m_lifetimeToken;
+  auto schema = getSchemaSnapshot();
+  submit([this, data, signerList, callback, token, schema] {
+    bool isValid = false;
+    try {
+      isValid = schema->passSchema(data.getName(), signerList) &&
+                ndnBLSVerify(schema->aggregateKey(signerList), data);
+    }
+    catch (const std::exception& e) {
+      NDN_LOG_INFO("Cannot verify " << data.getName() << ": " << e.what());
+    }
+    m_io.post([token, callback, isValid] {
+      if (!token.expired()) {
+        callback(isValid);
+      }
+    });
+  });
+}
+
+void
+VerifierEngine::submit(std::function<void()> task)
+{
+  auto& queue = *m_queues[m_nextQueue];
+  m_nextQueue = (m_nextQueue + 1) % m_queues.size();
+  {
+    std::lock_guard<std::mutex> lock(queue.m_mutex);
+    queue.m_tasks.push_back(std::move(task));
+  }
+  {
+    // counted once it is queued, so that a worker woken by the count finds it
+    std::lock_guard<std::mutex> lock(m_idleMutex);
+    m_nSubmitted++;
+  }
+  m_idleCondition.notify_one();
+}
+
+bool
+VerifierEngine::takeTask(size_t workerIndex, std::function<void()>& task)
+{
+  // the newest task of the own queue first
+  {
+    auto& queue = *m_queues[workerIndex];
+    std::lock_guard<std::mutex> lock(queue.m_mutex);
+    if (!queue.m_tasks.empty()) {
+      task = std::move(queue.m_tasks.back());
+      queue.m_tasks.pop_back();
+      return true;
+    }
+  }
+  // then the oldest task of another queue
+  for (size_t i = 1; i < m_queues.size(); i++) {
+    auto& queue = *m_queues[(workerIndex + i) % m_queues.size()];
+    std::lock_guard<std::mutex> lock(queue.m_mutex);
+    if (!queue.m_tasks.empty()) {
+      task = std::move(queue.m_tasks.front());
+      queue.m_tasks.pop_front();
+      m_nSteals++;
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+VerifierEngine::runWorker(size_t workerIndex)
+{
+  while (!m_isStopped) {
+    uint64_t nSubmitted = 0;
+    {
+      std::lock_guard<std::mutex> lock(m_idleMutex);
+      nSubmitted = m_nSubmitted;
+    }
+    std::function<void()> task;
+    if (takeTask(workerIndex, task)) {
+      task();
+      continue;
+    }
+    // a failed steal round sleeps until a task is queued after it started, instead of polling again
+    std::unique_lock<std::mutex> lock(m_idleMutex);
+    m_idleCondition.wait(lock, [this, nSubmitted] { return m_isStopped || m_nSubmitted != nSubmitted; });
+  }
+}
+
+}  // namespace mps
+}  // namespace ndn
@@ -10,8 +10,24 @@ namespace mps {
 
 NDN_LOG_INIT(ndnmps.blsverifier);
 
+/**
+ * @brief Decode the signer list carried in the content of the signature info Data.
+ */
+MpsSignerList
+readSignerList(const Data& signatureInfoData)
+{
+  MpsSignerList signerList;
+  const auto& signerListBlock = signatureInfoData.getContent();
+  signerListBlock.parse();
+  if (signerListBlock.get(tlv::MpsSignerList).isValid()) {
+    signerList.wireDecode(signerListBlock.get(tlv::MpsSignerList));
+  }
+  return signerList;
+}
+
 BLSVerifier::BLSVerifier(Face& face)
     : m_face(face)
+    , m_scheduler(face.getIoService())
 {
 }
 
@@ -31,14 +47,30 @@ BLSVerifier::verify(const Data& data, const Data& signatureInfoData)
     return false;
   }
 
-  // check signer list
-  MpsSignerList signerList;
-  const auto& signerListBlock = signatureInfoData.getContent();
-  signerListBlock.parse();
-  if (signerListBlock.get(tlv::MpsSignerList).isValid()) {
-    signerList.wireDecode(signerListBlock.get(tlv::MpsSignerList));
+  return verifySignerList(data, readSignerList(signatureInfoData));
+}
+
+bool
+BLSVerifier::verifySignerList(const Data& data, const MpsSignerList& signerList)
+{
+  BLSPublicKey aggKey;
+  if (!checkSignerList(data, signerList, aggKey)) {
+    return false;
   }
   auto begin = std::chrono::steady_clock::now();
+  auto verifyResult = ndnBLSVerify(aggKey, data);
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "Verifier verifying BLS signature: "
+            << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
+            << "[µs]" << std::endl;
+  return verifyResult;
+}
+
+bool
+BLSVerifier::checkSignerList(const Data& data, const MpsSignerList& signerList, BLSPublicKey& aggKey)
+{
+  // check signer list
+  auto begin = std::chrono::steady_clock::now();
   if (!m_schemaContainer.passSchema(data.getName(), signerList)) {
     NDN_LOG_INFO("signer list cannot pass the schema");
     return false;
@@ -48,21 +80,81 @@ BLSVerifier::verify(const Data& data, const Data& signatureInfoData)
             << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
             << "[µs]" << std::endl;
 
-  // verify signature
-  BLSPublicKey aggKey;
+  // aggregate the public keys
   begin = std::chrono::steady_clock::now();
   aggKey = m_schemaContainer.aggregateKey(signerList);
   end = std::chrono::steady_clock::now();
   std::cout << "Verifier aggregating public keys of size " << signerList.m_signers.size() << ": "
             << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
             << "[µs]" << std::endl;
-  begin = std::chrono::steady_clock::now();
-  auto verifyResult = ndnBLSVerify(aggKey, data);
-  end = std::chrono::steady_clock::now();
-  std::cout << "Verifier verifying BLS signature: "
+  return true;
+}
+
+void
+BLSVerifier::verifyOrQueue(const Data& data, const MpsSignerList& signerList, const VerifyFinishCallback& callback)
+{
+  if (m_engine != nullptr) {
+    m_engine->verify(data, signerList, callback);
+    return;
+  }
+  if (m_maxBatchSize == 0) {
+    callback(verifySignerList(data, signerList));
+    return;
+  }
+  BLSPublicKey aggKey;
+  if (!checkSignerList(data, signerList, aggKey)) {
+    callback(false);
+    return;
+  }
+  m_verificationQueue.push_back(QueuedVerification{data, aggKey, callback});
+  if (m_verificationQueue.size() >= m_maxBatchSize) {
+    flushVerificationQueue();
+  }
+  else if (m_verificationQueue.size() == 1) {
+    m_flushEvent = m_scheduler.schedule(m_maxBatchDelay, [this] { flushVerificationQueue(); });
+  }
+}
+
+void
+BLSVerifier::setVerifierEngine(VerifierEngine* engine)
+{
+  m_engine = engine;
+  if (m_engine != nullptr) {
+    m_engine->setSchemaContainer(m_schemaContainer);
+  }
+}
+
+void
+BLSVerifier::flushVerificationQueue()
+{
+  m_flushEvent.cancel();
+  if (m_verificationQueue.empty()) {
+    return;
+  }
+  // the callbacks may queue more packets into the next batch
+  auto batch = std::move(m_verificationQueue);
+  m_verificationQueue.clear();
+  std::vector<BLSPublicKey> pubKeys;
+  std::vector<Data> packets;
+  for (const auto& item : batch) {
+    pubKeys.push_back(item.m_aggKey);
+    packets.push_back(item.m_data);
+  }
+  auto begin = std::chrono::steady_clock::now();
+  auto invalidPackets = ndnBLSFindInvalidSignatures(pubKeys, packets);
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "Verifier verifying BLS signatures of batch size " << batch.size() << ": "
             << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
             << "[µs]" << std::endl;
-  return verifyResult;
+  m_nVerifiedBatches++;
+  auto invalidIt = invalidPackets.begin();
+  for (size_t i = 0; i < batch.size(); i++) {
+    bool isValid = invalidIt == invalidPackets.end() || *invalidIt != i;
+    if (!isValid) {
+      invalidIt++;
+    }
+    batch[i].m_callback(isValid);
+  }
 }
 
 void
@@ -77,22 +169,67 @@ BLSVerifier::asyncVerify(const Data& data, const VerifyFinishCallback& callback)
     return;
   }
 
+  const auto* signerList = m_signerInfoCache.find(keyLocatorName);
+  if (signerList != nullptr) {
+    verifyOrQueue(data, *signerList, callback);
+    return;
+  }
+  auto& pendingFetch = m_pendingFetches[keyLocatorName];
+  pendingFetch.m_waiters.emplace_back(data, callback);
+  if (pendingFetch.m_waiters.size() > 1) {
+    // the signature info Data is on the way
+    return;
+  }
+
   Interest interest(keyLocatorName);
   interest.setCanBePrefix(true);
   interest.setMustBeFresh(true);
-  m_face.expressInterest(
+  pendingFetch.m_handle = m_face.expressInterest(
       interest,
-      [&](const auto&, const auto& signatureInfoData) {
-        auto isValid = verify(data, signatureInfoData);
-        callback(isValid);
+      [this, keyLocatorName](const auto&, const auto& signatureInfoData) {
+        onSignerInfoFetched(keyLocatorName, &signatureInfoData);
       },
-      [&](const auto&, const auto&) {
-        callback(false);
+      [this, keyLocatorName](const auto&, const auto&) {
+        onSignerInfoFetched(keyLocatorName, nullptr);
       },
-      [&](const auto&) {
-        callback(false);
+      [this, keyLocatorName](const auto&) {
+        onSignerInfoFetched(keyLocatorName, nullptr);
       });
 }
 
+void
+BLSVerifier::onSignerInfoFetched(const Name& keyLocatorName, const Data* signatureInfoData)
+{
+  auto fetchIt = m_pendingFetches.find(keyLocatorName);
+  if (fetchIt == m_pendingFetches.end()) {
+    return;
+  }
+  // the callbacks may verify more packets of the same signature info Data, which are served from the cache
+  auto waiters = std::move(fetchIt->second.m_waiters);
+  fetchIt->second.m_handle.release();
+  m_pendingFetches.erase(fetchIt);
+
+  MpsSignerList signerList;
+  bool isDecoded = signatureInfoData != nullptr;
+  if (isDecoded) {
+    try {
+      signerList = readSignerList(*signatureInfoData);
+      m_signerInfoCache.insert(keyLocatorName, signerList, signatureInfoData->getFreshnessPeriod());
+    }
+    catch (const std::exception& e) {
+      NDN_LOG_INFO("bad signature info data " << signatureInfoData->getName() << ": " << e.what());
+      isDecoded = false;
+    }
+  }
+  for (const auto& waiter : waiters) {
+    if (isDecoded) {
+      verifyOrQueue(waiter.first, signerList, waiter.second);
+    }
+    else {
+      waiter.second(false);
+    }
+  }
+}
+
 }  // namespace mps
 }  // namespace ndn
\ No newline at end of file
@@ -1,13 +1,17 @@
 #include "ndnmps/bls-helpers.hpp"
+#include "ndnmps/verifier-engine.hpp"
 #include "test-common.hpp"
 #include <ndn-cxx/util/random.hpp>
+#include <algorithm>
 #include <iostream>
+#include <thread>
 
 namespace ndn {
 namespace mps {
 namespace tests {
 
-BOOST_AUTO_TEST_SUITE(TestBench)
+// benchmarks, left out of the default run: ./unit-tests --run_test=TestBench
+BOOST_AUTO_TEST_SUITE(TestBench, *boost::unit_test::disabled())
 
 void measureTime(int signer_size, int packet_size);
 
@@ -83,6 +87,84 @@ void measureTime(int signer_size, int packet_size) {
   std::cout << "Verification time: " << time_span.count() << " ms" << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(TestVerifierEngineScaling)
+{
+  ndnBLSInit();
+  const int signer_size = 4;
+  const int packet_count = 1000;
+
+  MultipartySchemaContainer container;
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/*");
+  schema.m_ruleId = "01";
+  schema.m_minOptionalSigners = 0;
+  std::vector<BLSSecretKey> sks;
+  std::vector<Name> signers;
+  for (int i = 0; i < signer_size; i++) {
+    BLSSecretKey sk;
+    BLSPublicKey pk;
+    blsSecretKeySetByCSPRNG(&sk);
+    blsGetPublicKey(&pk, &sk);
+    Name keyName("/signer" + std::to_string(i) + "/KEY/123");
+    sks.push_back(sk);
+    signers.push_back(keyName);
+    container.m_trustedIds.emplace(keyName, pk);
+    schema.m_signers.emplace_back(keyName);
+  }
+  container.m_schemas.push_back(schema);
+  MpsSignerList signerList(signers);
+
+  SignatureInfo info(static_cast<ndn::tlv::SignatureTypeValue>(tlv::SignatureSha256WithBls), Name("/signer/KEY/123"));
+  std::vector<Data> packets;
+  for (int i = 0; i < packet_count; i++) {
+    Data data;
+    data.setName(Name("/a").appendNumber(i));
+    Buffer buffer(128);
+    random::generateSecureBytes(buffer.data(), buffer.size());
+    data.setContent(std::make_shared<Buffer>(buffer));
+    std::vector<Buffer> sigs;
+    for (const auto& sk : sks) {
+      sigs.emplace_back(ndnGenBLSSignature(sk, data, info));
+    }
+    data.setSignatureInfo(info);
+    data.setSignatureValue(std::make_shared<Buffer>(ndnBLSAggregateSignature(sigs)));
+    data.wireEncode();
+    packets.push_back(data);
+  }
+
+  // powers of two below the number of cores, then all cores
+  size_t maxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  std::vector<size_t> threadCounts;
+  for (size_t nThreads = 1; nThreads < maxThreads; nThreads <<= 1) {
+    threadCounts.push_back(nThreads);
+  }
+  threadCounts.push_back(maxThreads);
+  for (size_t nThreads : threadCounts) {
+    boost::asio::io_service io;
+    boost::asio::io_service::work work(io);
+    VerifierEngine engine(io, nThreads);
+    engine.setSchemaContainer(container);
+    int nValid = 0;
+    int nDone = 0;
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (const auto& data : packets) {
+      engine.verify(data, signerList, [&](bool isValid) {
+        nDone++;
+        nValid += isValid;
+      });
+    }
+    while (nDone < packet_count) {
+      io.run_one();
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    auto time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+    BOOST_CHECK_EQUAL(nValid, packet_count);
+    std::cout << "Verifier engine with " << nThreads << " thread(s): " << time_span.count() << " s, "
+              << packet_count / time_span.count() << " packets/s, " << engine.getNSteals() << " steals" << std::endl;
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestBLSHelper
 
 }  // namespace tests
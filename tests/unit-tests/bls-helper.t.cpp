@@ -80,6 +80,35 @@ BOOST_AUTO_TEST_CASE(TestSignAndAggregateVerify)
   BOOST_CHECK(ndnBLSVerify(aggKey, interest));
 }
 
+BOOST_AUTO_TEST_CASE(TestFindInvalidSignatures)
+{
+  ndnBLSInit();
+
+  std::vector<BLSPublicKey> pks;
+  std::vector<Data> packets;
+  for (int i = 0; i < 7; i++) {
+    BLSSecretKey sk;
+    BLSPublicKey pk;
+    blsSecretKeySetByCSPRNG(&sk);
+    blsGetPublicKey(&pk, &sk);
+    Data data;
+    data.setName(Name("/a/b").appendNumber(i));
+    data.setContent(Name("/1/2/3/4").wireEncode());
+    ndnBLSSign(sk, data, Name("/signer/KEY/123"));
+    pks.push_back(pk);
+    packets.push_back(data);
+  }
+  BOOST_CHECK(ndnBLSFindInvalidSignatures(pks, packets).empty());
+
+  // a key that does not match, a signature of another packet, and a signature that cannot be decoded
+  std::swap(pks[1], pks[2]);
+  packets[4].setSignatureValue(std::make_shared<Buffer>(packets[5].getSignatureValue().value(),
+                                                        packets[5].getSignatureValue().value_size()));
+  packets[6].setSignatureValue(std::make_shared<Buffer>(10));
+  BOOST_CHECK(ndnBLSFindInvalidSignatures(pks, packets) == std::vector<size_t>({1, 2, 4, 6}));
+  BOOST_CHECK_THROW(ndnBLSFindInvalidSignatures(std::vector<BLSPublicKey>(1, pks[0]), packets), std::runtime_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestBLSHelper
 
 }  // namespace tests
@@ -0,0 +1,77 @@
+#include "ndnmps/crypto-helpers.hpp"
+#include "test-common.hpp"
+#include <ndn-cxx/util/random.hpp>
+#include <thread>
+
+namespace ndn {
+namespace mps {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestCryptoHelpers)
+
+BOOST_AUTO_TEST_CASE(EcdhKeyPool)
+{
+  ECDHKeyPool pool(4, 2);
+  // the background thread only starts with the first acquisition
+  BOOST_CHECK_EQUAL(pool.size(), 0);
+  auto first = pool.acquire();
+  // wait for the background thread to fill the pool
+  for (int i = 0; i < 100 && pool.size() < 4; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  BOOST_CHECK_EQUAL(pool.size(), 4);
+
+  auto alice = pool.acquire();
+  auto bob = pool.acquire();
+  BOOST_CHECK(alice->getSelfPubKey() != bob->getSelfPubKey());
+  auto aliceSecret = alice->deriveSecret(bob->getSelfPubKey());
+  auto bobSecret = bob->deriveSecret(alice->getSelfPubKey());
+  BOOST_CHECK(aliceSecret == bobSecret);
+
+  // drain the pool, the remaining keys are generated synchronously
+  std::vector<std::unique_ptr<ECDHState>> keys;
+  for (int i = 0; i < 8; i++) {
+    keys.push_back(pool.acquire());
+    BOOST_CHECK_EQUAL(keys.back()->getSelfPubKey().size(), 65);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(EcdhKeyPoolDisabled)
+{
+  ECDHKeyPool pool(0);
+  auto alice = pool.acquire();
+  auto bob = pool.acquire();
+  BOOST_CHECK(alice->deriveSecret(bob->getSelfPubKey()) == bob->deriveSecret(alice->getSelfPubKey()));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  BOOST_CHECK_EQUAL(pool.size(), 0);
+
+  BOOST_CHECK(ECDHKeyPool::getShared() == ECDHKeyPool::getShared());
+}
+
+BOOST_AUTO_TEST_CASE(HmacWithRawKey)
+{
+  std::array<uint8_t, 32> key;
+  random::generateSecureBytes(key.data(), key.size());
+  std::array<uint8_t, 32> wrongKey = key;
+  wrongKey[0] ^= 0xFF;
+
+  Data data(Name("/initiator/mps/param/123"));
+  data.setContent(Name("/1/2/3/4").wireEncode());
+  signDataWithHmac(data, key.data(), key.size(), Name("/signer/mps/result/456"));
+  BOOST_CHECK_EQUAL(data.getSignatureType(), ndn::tlv::SignatureHmacWithSha256);
+  BOOST_CHECK(verifyDataWithHmac(data, key.data(), key.size()));
+  BOOST_CHECK(!verifyDataWithHmac(data, wrongKey.data(), wrongKey.size()));
+
+  Interest interest(Name("/signer/mps/result/456").appendVersion(0));
+  signInterestWithHmac(interest, key.data(), key.size(), Name("/signer/mps/result/456"));
+  BOOST_CHECK(interest.isSigned());
+  BOOST_CHECK(verifyInterestWithHmac(interest, key.data(), key.size()));
+  BOOST_CHECK(!verifyInterestWithHmac(interest, wrongKey.data(), wrongKey.size()));
+  BOOST_CHECK(!verifyInterestWithHmac(Interest(Name("/signer/mps/result/456")), key.data(), key.size()));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCryptoHelpers
+
+}  // namespace tests
+}  // namespace mps
+}  // namespace ndn
@@ -86,6 +86,17 @@ BOOST_AUTO_TEST_CASE(Equality)
   BOOST_CHECK_EQUAL(a != b, false);
 }
 
+BOOST_AUTO_TEST_CASE(Merge)
+{
+  MpsSignerList a(std::vector<Name>{"/A", "/B"});
+  BOOST_CHECK(a.merge(MpsSignerList(std::vector<Name>{"/C", "/D"})));
+  BOOST_CHECK(a == MpsSignerList(std::vector<Name>{"/A", "/B", "/C", "/D"}));
+
+  // a shared signer would be counted twice, nothing is merged
+  BOOST_CHECK(!a.merge(MpsSignerList(std::vector<Name>{"/E", "/B"})));
+  BOOST_CHECK_EQUAL(a.m_signers.size(), 4);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // TestMpsSignerList
 
 }  // namespace tests
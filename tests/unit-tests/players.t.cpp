@@ -3,8 +3,12 @@
 #include "ndnmps/signer.hpp"
 #include "ndnmps/verifier.hpp"
 #include "ndnmps/initiator.hpp"
+#include "ndnmps/sub-aggregator.hpp"
 #include "test-common.hpp"
 #include "identity-management-fixture.hpp"
+#include <algorithm>
+#include <set>
+#include <thread>
 
 namespace ndn {
 namespace mps {
@@ -57,6 +61,7 @@ BOOST_AUTO_TEST_CASE(SingleSigner)
                             });
   advanceClocks(time::milliseconds(100), 11);
   BOOST_CHECK(callbackInvoked);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingRequests, 0);
   BOOST_CHECK(!verifier.verify(signedData, infoData));
   verifier.m_schemaContainer.m_schemas.push_back(schema);
   verifier.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
@@ -198,6 +203,1782 @@ BOOST_AUTO_TEST_CASE(SignerReplacement)
   BOOST_CHECK(verifier.verify(signedData, infoData));
   }
 
+BOOST_AUTO_TEST_CASE(SignerRequestTable)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  SignerLimits limits;
+  limits.maxPendingRequests = 2;
+  limits.requestLifetime = time::seconds(2);
+  signer.setLimits(limits);
+  advanceClocks(time::milliseconds(20), 10);
+
+  // sign requests from initiators that never answer the parameter fetch
+  for (int i = 0; i < 3; i++) {
+    ECDHState ecdh;
+    Interest request(Name("/signer/mps/sign"));
+    Block appParam(ndn::tlv::ApplicationParameters);
+    appParam.push_back(makeNestedBlock(tlv::ParameterDataName, Name("/initiator/mps/param").appendNumber(i)));
+    appParam.push_back(makeBinaryBlock(tlv::EcdhPub, ecdh.getSelfPubKey().data(), ecdh.getSelfPubKey().size()));
+    appParam.encode();
+    request.setApplicationParameters(appParam);
+    face.receive(request);
+    advanceClocks(time::milliseconds(10), 1);
+  }
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingRequests, 2);
+  BOOST_CHECK_EQUAL(signer.getCounters().nEvictedRequests, 1);
+  BOOST_CHECK_GT(signer.getCounters().nPendingBytes, 0);
+
+  advanceClocks(time::milliseconds(100), 30);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingRequests, 0);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingBytes, 0);
+  BOOST_CHECK_EQUAL(signer.getCounters().nExpiredRequests, 2);
+}
+
+BOOST_AUTO_TEST_CASE(SignerRequestGrowthLimit)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  SignerLimits limits;
+  limits.maxPendingBytes = 16 * 1024;
+  signer.setLimits(limits);
+  // the delegated result is larger than the byte limit
+  signer.setDelegatedSignCallback([](const std::vector<Data>& batch, const DelegatedSignCompletion& done) {
+    done(std::vector<Buffer>(batch.size(), Buffer(32 * 1024)), MpsSignerList(std::vector<Name>{Name("/leaf/KEY/1")}));
+  });
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+  bool failureInvoked = false;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [](const auto&, const auto&) { BOOST_CHECK(false); },
+                           [&](const auto&) { failureInvoked = true; });
+  advanceClocks(time::milliseconds(100), 30);
+  BOOST_CHECK(failureInvoked);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingRequests, 0);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingBytes, 0);
+}
+
+BOOST_AUTO_TEST_CASE(SessionResumption)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  signer.setSessionLifetime(time::seconds(60));
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.setSessionLifetime(time::seconds(60));
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  advanceClocks(time::milliseconds(20), 10);
+
+  BLSVerifier verifier(face);
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+
+  for (int i = 0; i < 2; i++) {
+    Data unsignedData;
+    unsignedData.setName(Name("/a/b").appendNumber(i));
+    unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+    bool callbackInvoked = false;
+    Data signedData, infoData;
+    initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                             [&](const auto& d1, const auto& d2) {
+                               callbackInvoked = true;
+                               signedData = d1;
+                               infoData = d2;
+                             },
+                             [](const auto& reason) {
+                               BOOST_CHECK(false);
+                             });
+    advanceClocks(time::milliseconds(100), 11);
+    BOOST_CHECK(callbackInvoked);
+    BOOST_CHECK(verifier.verify(signedData, infoData));
+  }
+
+  // the first request runs ECDH, the second one resumes the session
+  std::vector<Interest> signRequests;
+  for (const auto& interest : face.sentInterests) {
+    if (Name("/signer/mps/sign").isPrefixOf(interest.getName())) {
+      signRequests.push_back(interest);
+    }
+  }
+  BOOST_REQUIRE_EQUAL(signRequests.size(), 2);
+  const auto& firstParams = signRequests[0].getApplicationParameters();
+  firstParams.parse();
+  BOOST_CHECK(firstParams.find(tlv::EcdhPub) != firstParams.elements_end());
+  const auto& secondParams = signRequests[1].getApplicationParameters();
+  secondParams.parse();
+  BOOST_CHECK(secondParams.find(tlv::EcdhPub) == secondParams.elements_end());
+  BOOST_CHECK(secondParams.find(tlv::SessionId) != secondParams.elements_end());
+}
+
+BOOST_AUTO_TEST_CASE(InlineSigning)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.setInlineParameterLimit(4096);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  advanceClocks(time::milliseconds(20), 10);
+
+  BLSVerifier verifier(face);
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+  bool callbackInvoked = false;
+  Data signedData, infoData;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [&](const auto& d1, const auto& d2) {
+                             callbackInvoked = true;
+                             signedData = d1;
+                             infoData = d2;
+                           },
+                           [](const auto& reason) {
+                             BOOST_CHECK(false);
+                           });
+  // no ResultAfter wait is involved
+  advanceClocks(time::milliseconds(10), 10);
+  BOOST_CHECK(callbackInvoked);
+  BOOST_CHECK(verifier.verify(signedData, infoData));
+  for (const auto& interest : face.sentInterests) {
+    BOOST_CHECK(!Name("/initiator/mps/param").isPrefixOf(interest.getName()));
+    BOOST_CHECK(!Name("/signer/mps/result").isPrefixOf(interest.getName()));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(InlineSigningSharedKeyFetch)
+{
+  // the signer is not reachable, so the static key fetch times out after the sessions expired
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  util::DummyClientFace signerFace(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), signerFace, m_keyChain, Name("/signer/KEY/123"));
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.setInlineParameterLimit(4096);
+  initiator.setSessionDeadline(time::seconds(1));
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+  face.sentInterests.clear();
+
+  int nFailures = 0;
+  for (int i = 0; i < 2; i++) {
+    Data unsignedData;
+    unsignedData.setName(Name("/a/b").appendNumber(i));
+    unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+    initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                             [](const auto&, const auto&) { BOOST_CHECK(false); },
+                             [&](const auto&) { nFailures++; });
+  }
+  advanceClocks(time::milliseconds(100), 60);
+  BOOST_CHECK_EQUAL(nFailures, 2);
+  size_t nKeyFetches = 0;
+  for (const auto& interest : face.sentInterests) {
+    if (Name("/signer/mps/ecdh").isPrefixOf(interest.getName())) {
+      nKeyFetches++;
+    }
+    // the expired sessions do not fall back to the full protocol
+    BOOST_CHECK(!Name("/signer/mps/sign").isPrefixOf(interest.getName()));
+  }
+  BOOST_CHECK_EQUAL(nKeyFetches, 1);
+}
+
+BOOST_AUTO_TEST_CASE(LongPollResult)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  signer.setLongPollHold(time::seconds(2));
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  advanceClocks(time::milliseconds(20), 10);
+
+  BLSVerifier verifier(face);
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+  bool callbackInvoked = false;
+  Data signedData, infoData;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [&](const auto& d1, const auto& d2) {
+                             callbackInvoked = true;
+                             signedData = d1;
+                             infoData = d2;
+                           },
+                           [](const auto& reason) {
+                             BOOST_CHECK(false);
+                           });
+  // well under the one-second ResultAfter of the polling mode
+  advanceClocks(time::milliseconds(10), 20);
+  BOOST_CHECK(callbackInvoked);
+  BOOST_CHECK(verifier.verify(signedData, infoData));
+  size_t nResultInterests = 0;
+  for (const auto& interest : face.sentInterests) {
+    if (Name("/signer/mps/result").isPrefixOf(interest.getName())) {
+      nResultInterests++;
+    }
+  }
+  BOOST_CHECK_EQUAL(nResultInterests, 1);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingRequests, 0);
+}
+
+BOOST_AUTO_TEST_CASE(AdaptiveResultPolling)
+{
+  // the signer ACKs with Processing and a one-second ResultAfter, then serves the share once it is ready
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  // the number of 10 ms steps until the signing finishes
+  auto signOnce = [&] (int i) {
+    Data unsignedData;
+    unsignedData.setName(Name("/a/b").appendNumber(i));
+    unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+    bool callbackInvoked = false;
+    initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                             [&](const auto&, const auto&) { callbackInvoked = true; },
+                             [](const auto&) { BOOST_CHECK(false); });
+    int nSteps = 0;
+    for (; nSteps < 300 && !callbackInvoked; nSteps++) {
+      advanceClocks(time::milliseconds(10));
+    }
+    BOOST_CHECK(callbackInvoked);
+    return nSteps;
+  };
+
+  // without a history, the first fetch waits for the one-second ResultAfter hint
+  BOOST_CHECK_GE(signOnce(0), 100);
+  // the signer reports a service time far below the hint, so the next first fetch comes earlier
+  auto firstDelay = initiator.getResultPoller().getFirstDelay(Name("/signer/KEY/123"), time::seconds(1));
+  BOOST_CHECK_LT(firstDelay, time::milliseconds(100));
+  BOOST_CHECK_LT(signOnce(1), 50);
+}
+
+BOOST_AUTO_TEST_CASE(SignerAdmissionControl)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  SignerLimits limits;
+  limits.initiatorRate = 1;
+  limits.initiatorBurst = 2;
+  limits.maxQueuedRequests = 3;
+  signer.setLimits(limits);
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto sendRequest = [&] (int i) {
+    ECDHState ecdh;
+    Interest request(Name("/signer/mps/sign"));
+    Block appParam(ndn::tlv::ApplicationParameters);
+    appParam.push_back(makeNestedBlock(tlv::ParameterDataName, Name("/initiator/mps/param").appendNumber(i)));
+    appParam.push_back(makeBinaryBlock(tlv::EcdhPub, ecdh.getSelfPubKey().data(), ecdh.getSelfPubKey().size()));
+    appParam.encode();
+    request.setApplicationParameters(appParam);
+    face.sentData.clear();
+    face.receive(request);
+    advanceClocks(time::milliseconds(10), 1);
+    BOOST_REQUIRE(!face.sentData.empty());
+    auto content = face.sentData.back().getContent();
+    content.parse();
+    return readString(content.get(tlv::Status));
+  };
+  // the burst of the initiator is admitted, the rest is over its rate
+  BOOST_CHECK_EQUAL(sendRequest(0), "102");
+  BOOST_CHECK_EQUAL(sendRequest(1), "102");
+  BOOST_CHECK_EQUAL(sendRequest(2), "503");
+  auto content = face.sentData.back().getContent();
+  content.parse();
+  BOOST_CHECK_GT(readNonNegativeInteger(content.get(tlv::RetryAfter)), 0);
+  BOOST_CHECK_EQUAL(signer.getCounters().nRejectedRequests, 1);
+
+  // after the refill, the global queue limit applies
+  advanceClocks(time::milliseconds(100), 20);
+  BOOST_CHECK_EQUAL(sendRequest(3), "102");
+  BOOST_CHECK_EQUAL(sendRequest(4), "503");
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingRequests, 3);
+  BOOST_CHECK_EQUAL(signer.getCounters().nRejectedRequests, 2);
+}
+
+BOOST_AUTO_TEST_CASE(LongPollRetransmission)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  signer.setLongPollHold(time::seconds(2));
+  // keep the request processing until the test decides
+  PolicyDecisionCallback decide;
+  signer.setAsyncVerifyToBeSignedCallback([&](const Data&, const PolicyDecisionCallback& done) { decide = done; });
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+  bool callbackInvoked = false;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [&](const auto&, const auto&) { callbackInvoked = true; },
+                           [](const auto&) { BOOST_CHECK(false); });
+  advanceClocks(time::milliseconds(10), 10);
+  BOOST_REQUIRE(decide != nullptr);
+
+  auto countResultData = [&] {
+    return std::count_if(face.sentData.begin(), face.sentData.end(), [](const Data& data) {
+      return Name("/signer/mps/result").isPrefixOf(data.getName());
+    });
+  };
+  auto resultInterest = std::find_if(face.sentInterests.begin(), face.sentInterests.end(), [](const Interest& interest) {
+    return Name("/signer/mps/result").isPrefixOf(interest.getName());
+  });
+  BOOST_REQUIRE(resultInterest != face.sentInterests.end());
+  BOOST_CHECK_EQUAL(countResultData(), 0);
+
+  // the retransmitted result Interest releases the held one with Processing
+  Interest retransmission(*resultInterest);
+  retransmission.refreshNonce();
+  face.receive(retransmission);
+  advanceClocks(time::milliseconds(1), 1);
+  BOOST_CHECK_GE(countResultData(), 1);
+
+  decide(true);
+  advanceClocks(time::milliseconds(10), 20);
+  BOOST_CHECK(callbackInvoked);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingRequests, 0);
+}
+
+BOOST_AUTO_TEST_CASE(OverloadedSignerReplaced)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  std::vector<std::unique_ptr<BLSSigner>> signers;
+  for (size_t i = 0; i < 3; i++) {
+    std::string prefix = "/signer" + std::to_string(i + 1);
+    signers.emplace_back(std::make_unique<BLSSigner>(Name(prefix), face, m_keyChain, Name(prefix + "/KEY/123")));
+  }
+  // /signer2 admits no request from the initiator
+  SignerLimits limits;
+  limits.initiatorRate = 0.01;
+  limits.initiatorBurst = 0.5;
+  signers[1]->setLimits(limits);
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  for (size_t i = 0; i < 3; i++) {
+    initiator.m_schemaContainer.m_trustedIds.emplace(signers[i]->getPublicKeyName(), signers[i]->getPublicKey());
+  }
+  advanceClocks(time::milliseconds(20), 10);
+
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer1/KEY/123"));
+  schema.m_minOptionalSigners = 1;
+  schema.m_optionalSigners.emplace_back(Name("/signer2/KEY/123"));
+  schema.m_optionalSigners.emplace_back(Name("/signer3/KEY/123"));
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+  bool callbackInvoked = false;
+  Data signedData, infoData;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [&](const auto& d1, const auto& d2) {
+                             callbackInvoked = true;
+                             signedData = d1;
+                             infoData = d2;
+                           },
+                           [](const auto& reason) {
+                             BOOST_CHECK(false);
+                           });
+  // replaced without waiting for a timeout
+  advanceClocks(time::milliseconds(100), 15);
+  BOOST_CHECK(callbackInvoked);
+  BOOST_CHECK_EQUAL(signers[1]->getCounters().nRejectedRequests, 1);
+  const auto& signerListBlock = infoData.getContent();
+  signerListBlock.parse();
+  MpsSignerList signerList;
+  signerList.wireDecode(signerListBlock.get(tlv::MpsSignerList));
+  BOOST_CHECK(std::find(signerList.m_signers.begin(), signerList.m_signers.end(),
+                        Name("/signer2/KEY/123")) == signerList.m_signers.end());
+  BOOST_CHECK(std::find(signerList.m_signers.begin(), signerList.m_signers.end(),
+                        Name("/signer3/KEY/123")) != signerList.m_signers.end());
+}
+
+BOOST_AUTO_TEST_CASE(AdmissionBeforePolicy)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  SignerLimits limits;
+  limits.maxPendingPolicyChecks = 2;
+  signer.setLimits(limits);
+  std::vector<PolicyDecisionCallback> pendingDecisions;
+  signer.setAsyncVerifySignRequestCallback([&] (const Interest&, const PolicyDecisionCallback& done) {
+    pendingDecisions.push_back(done);
+  });
+  advanceClocks(time::milliseconds(20), 10);
+
+  for (int i = 0; i < 4; i++) {
+    ECDHState ecdh;
+    Interest request(Name("/signer/mps/sign"));
+    Block appParam(ndn::tlv::ApplicationParameters);
+    appParam.push_back(makeNestedBlock(tlv::ParameterDataName, Name("/initiator/mps/param").appendNumber(i)));
+    appParam.push_back(makeBinaryBlock(tlv::EcdhPub, ecdh.getSelfPubKey().data(), ecdh.getSelfPubKey().size()));
+    appParam.encode();
+    request.setApplicationParameters(appParam);
+    face.receive(request);
+    advanceClocks(time::milliseconds(10), 1);
+  }
+  // the requests over the limit are shed before their policy is checked
+  BOOST_CHECK_EQUAL(pendingDecisions.size(), 2);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingPolicyChecks, 2);
+  BOOST_CHECK_EQUAL(signer.getCounters().nRejectedRequests, 2);
+
+  for (const auto& decide : pendingDecisions) {
+    decide(false);
+  }
+  advanceClocks(time::milliseconds(10), 1);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingPolicyChecks, 0);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingRequests, 0);
+}
+
+BOOST_AUTO_TEST_CASE(InlineSigningKeyRotation)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  BLSPublicKey alicePub = signer.addKey(Name("/signer/alice/KEY/1"));
+  signer.addKey(Name("/signer/bob/KEY/1"));
+  advanceClocks(time::milliseconds(20), 10);
+
+  // each hosted key publishes its own static ECDH key
+  auto fetchStaticKey = [&] (const Name& identity) {
+    Block staticKey;
+    Interest keyInterest(Name(identity).append("mps").append("ecdh"));
+    keyInterest.setCanBePrefix(true);
+    keyInterest.setMustBeFresh(true);
+    face.expressInterest(keyInterest,
+                         [&](const auto&, const auto& keyData) {
+                           keyData.getContent().parse();
+                           staticKey = keyData.getContent().get(tlv::EcdhPub);
+                         },
+                         nullptr, nullptr);
+    advanceClocks(time::milliseconds(20), 5);
+    return staticKey;
+  };
+  auto aliceStaticKey = fetchStaticKey(Name("/signer/alice"));
+  BOOST_REQUIRE(aliceStaticKey.isValid());
+  BOOST_CHECK(aliceStaticKey != fetchStaticKey(Name("/signer/bob")));
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.setInlineParameterLimit(4096);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/alice/KEY/1"), alicePub);
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/alice/KEY/1"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+  auto signOnce = [&] {
+    face.sentInterests.clear();
+    bool callbackInvoked = false;
+    initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                             [&](const auto&, const auto&) { callbackInvoked = true; },
+                             [](const auto&) { BOOST_CHECK(false); });
+    advanceClocks(time::milliseconds(100), 30);
+    BOOST_CHECK(callbackInvoked);
+    size_t nParameterFetches = 0;
+    for (const auto& interest : face.sentInterests) {
+      if (Name("/initiator/mps/param").isPrefixOf(interest.getName())) {
+        nParameterFetches++;
+      }
+    }
+    return nParameterFetches;
+  };
+  BOOST_CHECK_EQUAL(signOnce(), 0);
+
+  // the key is replaced, but the initiator's cached key is accepted for one more period
+  advanceClocks(time::minutes(10), 6);
+  BOOST_CHECK(aliceStaticKey != fetchStaticKey(Name("/signer/alice")));
+  BOOST_CHECK_EQUAL(signOnce(), 0);
+
+  // once dropped, the signer answers with a signed 400 and the initiator falls back to the full protocol
+  advanceClocks(time::minutes(10), 6);
+  BOOST_CHECK_EQUAL(signOnce(), 1);
+  BOOST_CHECK_EQUAL(signOnce(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(MultiKeySigner)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  BLSPublicKey alicePub = signer.addKey(Name("/signer/alice/KEY/1"));
+  BLSPublicKey bobPub = signer.addKey(Name("/signer/bob/KEY/1"));
+  BOOST_CHECK_THROW(signer.addKey(Name("/other/KEY/1")), std::runtime_error);
+  BOOST_CHECK_EQUAL(signer.getNKeys(), 3);
+  advanceClocks(time::milliseconds(20), 10);
+  // one prefix registration serves all the keys
+  size_t nRegistrations = 0;
+  for (const auto& interest : face.sentInterests) {
+    if (Name("/localhost/nfd/rib/register").isPrefixOf(interest.getName())) {
+      nRegistrations++;
+    }
+  }
+  BOOST_CHECK_EQUAL(nRegistrations, 1);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  BLSVerifier verifier(face);
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/alice/KEY/1"));
+  schema.m_signers.emplace_back(Name("/signer/bob/KEY/1"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_schemas.push_back(schema);
+  for (auto* container : {&initiator.m_schemaContainer, &verifier.m_schemaContainer}) {
+    container->m_trustedIds.emplace(Name("/signer/alice/KEY/1"), alicePub);
+    container->m_trustedIds.emplace(Name("/signer/bob/KEY/1"), bobPub);
+  }
+  advanceClocks(time::milliseconds(20), 10);
+
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+  bool callbackInvoked = false;
+  Data signedData, infoData;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [&](const auto& d1, const auto& d2) {
+                             callbackInvoked = true;
+                             signedData = d1;
+                             infoData = d2;
+                           },
+                           [](const auto& reason) {
+                             BOOST_CHECK(false);
+                           });
+  advanceClocks(time::milliseconds(100), 30);
+  BOOST_CHECK(callbackInvoked);
+  BOOST_CHECK(verifier.verify(signedData, infoData));
+
+  // requests to an unloaded key are rejected
+  BOOST_CHECK(signer.removeKey(Name("/signer/bob/KEY/1")));
+  BOOST_CHECK(!signer.removeKey(Name("/signer/bob/KEY/1")));
+  BOOST_CHECK_THROW(signer.removeKey(Name("/signer/KEY/123")), std::runtime_error);
+  bool failureInvoked = false;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [](const auto&, const auto&) { BOOST_CHECK(false); },
+                           [&](const auto& reason) { failureInvoked = true; });
+  advanceClocks(time::milliseconds(100), 30);
+  BOOST_CHECK(failureInvoked);
+}
+
+BOOST_AUTO_TEST_CASE(AsyncPolicy)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  std::vector<PolicyDecisionCallback> pendingDecisions;
+  signer.setAsyncVerifyToBeSignedCallback([&] (const Data&, const PolicyDecisionCallback& done) {
+    pendingDecisions.push_back(done);
+  });
+  signer.setPolicyTimeout(time::seconds(1));
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+  bool callbackInvoked = false;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [&](const auto&, const auto&) { callbackInvoked = true; },
+                           [](const auto& reason) { BOOST_CHECK(false); });
+  advanceClocks(time::milliseconds(10), 20);
+  BOOST_REQUIRE_EQUAL(pendingDecisions.size(), 1);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingPolicyChecks, 1);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingRequests, 1);
+
+  // the decision comes from another thread
+  std::thread policyThread([&] { pendingDecisions[0](true); });
+  policyThread.join();
+  advanceClocks(time::milliseconds(100), 20);
+  BOOST_CHECK(callbackInvoked);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingPolicyChecks, 0);
+
+  // without a decision, the request is denied once the policy timeout is over
+  bool failureInvoked = false;
+  unsignedData.setName(Name("/a/b/d"));
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [](const auto&, const auto&) { BOOST_CHECK(false); },
+                           [&](const auto&) { failureInvoked = true; });
+  advanceClocks(time::milliseconds(100), 30);
+  BOOST_CHECK_EQUAL(pendingDecisions.size(), 2);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPolicyTimeouts, 1);
+  BOOST_CHECK(failureInvoked);
+  // a late decision is ignored
+  pendingDecisions[1](true);
+  advanceClocks(time::milliseconds(10), 1);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingPolicyChecks, 0);
+}
+
+BOOST_AUTO_TEST_CASE(AsyncBatchPolicy)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  std::vector<PolicyDecisionCallback> pendingDecisions;
+  signer.setAsyncVerifyToBeSignedCallback([&] (const Data&, const PolicyDecisionCallback& done) {
+    pendingDecisions.push_back(done);
+  });
+  SignerLimits limits;
+  limits.maxPendingPolicyChecks = 4;
+  signer.setLimits(limits);
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto makeBatch = [] (size_t size) {
+    std::vector<Data> batch;
+    for (size_t i = 0; i < size; i++) {
+      Data unsignedData;
+      unsignedData.setName(Name("/a/b").appendNumber(i));
+      unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+      batch.push_back(unsignedData);
+    }
+    return batch;
+  };
+
+  // a batch that needs more checks than the limit allows is denied without starting any
+  bool failureInvoked = false;
+  initiator.multiPartySignBatch(makeBatch(5), schema, initiatorId.getDefaultKey().getName(),
+                                [](const auto&, const auto&) { BOOST_CHECK(false); },
+                                [&](const auto&) { failureInvoked = true; });
+  advanceClocks(time::milliseconds(100), 30);
+  BOOST_CHECK(failureInvoked);
+  BOOST_CHECK_EQUAL(pendingDecisions.size(), 0);
+
+  // the first rejection decides the batch and drops the checks still pending
+  failureInvoked = false;
+  initiator.multiPartySignBatch(makeBatch(3), schema, initiatorId.getDefaultKey().getName(),
+                                [](const auto&, const auto&) { BOOST_CHECK(false); },
+                                [&](const auto&) { failureInvoked = true; });
+  advanceClocks(time::milliseconds(10), 20);
+  BOOST_REQUIRE_EQUAL(pendingDecisions.size(), 3);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingPolicyChecks, 3);
+  pendingDecisions[1](false);
+  advanceClocks(time::milliseconds(10), 1);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingPolicyChecks, 0);
+  // late decisions of the dropped checks are ignored
+  pendingDecisions[0](true);
+  pendingDecisions[2](true);
+  advanceClocks(time::milliseconds(100), 30);
+  BOOST_CHECK(failureInvoked);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPendingPolicyChecks, 0);
+  BOOST_CHECK_EQUAL(signer.getCounters().nPolicyTimeouts, 0);
+}
+
+BOOST_AUTO_TEST_CASE(NonBlockingParameterServing)
+{
+  util::DummyClientFace initiatorFace(io, m_keyChain, { true, true });
+  util::DummyClientFace signerFace(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), signerFace, m_keyChain, Name("/signer/KEY/123"));
+
+  // bridge the two faces, holding the signer's ACKs back while holdAcks is set
+  bool holdAcks = true;
+  std::vector<Data> heldAcks;
+  initiatorFace.onSendInterest.connect([&] (const Interest& interest) {
+    if (Name("/signer").isPrefixOf(interest.getName())) {
+      io.post([&signerFace, interest] { signerFace.receive(interest); });
+    }
+  });
+  initiatorFace.onSendData.connect([&] (const Data& data) {
+    io.post([&signerFace, data] { signerFace.receive(data); });
+  });
+  signerFace.onSendInterest.connect([&] (const Interest& interest) {
+    if (Name("/initiator").isPrefixOf(interest.getName())) {
+      io.post([&initiatorFace, interest] { initiatorFace.receive(interest); });
+    }
+  });
+  signerFace.onSendData.connect([&] (const Data& data) {
+    if (holdAcks && Name("/signer/mps/sign").isPrefixOf(data.getName())) {
+      heldAcks.push_back(data);
+      return;
+    }
+    io.post([&initiatorFace, data] { initiatorFace.receive(data); });
+  });
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, initiatorFace, scheduler);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  const size_t nSessions = 32;
+  size_t nFinished = 0;
+  for (size_t i = 0; i < nSessions; i++) {
+    Data unsignedData;
+    unsignedData.setName(Name("/a/b").appendNumber(i));
+    unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+    initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                             [&](const auto&, const auto&) { nFinished++; },
+                             [](const auto& reason) { BOOST_CHECK(false); });
+  }
+  // every parameter fetch reaches the initiator before its ACK does
+  size_t nLoopIterations = 0;
+  scheduler.schedule(time::milliseconds(50), [&] { nLoopIterations++; });
+  advanceClocks(time::milliseconds(10), 10);
+  BOOST_CHECK_EQUAL(heldAcks.size(), nSessions);
+  BOOST_CHECK_EQUAL(nLoopIterations, 1); // the loop kept running
+  for (const auto& data : initiatorFace.sentData) {
+    BOOST_CHECK(!Name("/initiator/mps/param").isPrefixOf(data.getName()));
+  }
+
+  // the queued parameter Interests are answered as soon as the ACKs are processed
+  holdAcks = false;
+  for (const auto& ack : heldAcks) {
+    initiatorFace.receive(ack);
+  }
+  advanceClocks(time::milliseconds(10), 10);
+  size_t nParameterData = 0;
+  for (const auto& data : initiatorFace.sentData) {
+    if (Name("/initiator/mps/param").isPrefixOf(data.getName())) {
+      nParameterData++;
+    }
+  }
+  BOOST_CHECK_EQUAL(nParameterData, nSessions);
+  advanceClocks(time::milliseconds(100), 30);
+  BOOST_CHECK_EQUAL(nFinished, nSessions);
+}
+
+BOOST_AUTO_TEST_CASE(GroupParameter)
+{
+  util::DummyClientFace initiatorFace(io, m_keyChain, { true, true });
+  util::DummyClientFace signerFace(io, m_keyChain, { true, true });
+  std::vector<std::unique_ptr<BLSSigner>> signers;
+  for (size_t i = 0; i < 3; i++) {
+    std::string prefix = "/signer" + std::to_string(i + 1);
+    signers.emplace_back(std::make_unique<BLSSigner>(Name(prefix), signerFace, m_keyChain, Name(prefix + "/KEY/123")));
+  }
+
+  // bridge the two faces, counting the group parameter Data answered by the initiator
+  std::vector<Data> groupParameterData;
+  initiatorFace.onSendInterest.connect([&] (const Interest& interest) {
+    io.post([&signerFace, interest] { signerFace.receive(interest); });
+  });
+  initiatorFace.onSendData.connect([&] (const Data& data) {
+    io.post([&signerFace, data] { signerFace.receive(data); });
+  });
+  signerFace.onSendInterest.connect([&] (const Interest& interest) {
+    if (Name("/initiator").isPrefixOf(interest.getName())) {
+      io.post([&initiatorFace, interest] { initiatorFace.receive(interest); });
+    }
+  });
+  signerFace.onSendData.connect([&] (const Data& data) {
+    io.post([&initiatorFace, data] { initiatorFace.receive(data); });
+  });
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, initiatorFace, scheduler);
+  initiator.setGroupParameterMode(true);
+  BLSVerifier verifier(initiatorFace);
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  for (size_t i = 0; i < 3; i++) {
+    schema.m_signers.emplace_back(signers[i]->getPublicKeyName());
+    initiator.m_schemaContainer.m_trustedIds.emplace(signers[i]->getPublicKeyName(), signers[i]->getPublicKey());
+    verifier.m_schemaContainer.m_trustedIds.emplace(signers[i]->getPublicKeyName(), signers[i]->getPublicKey());
+  }
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  std::vector<uint8_t> content(4096, 0xab);
+  unsignedData.setContent(content.data(), content.size());
+  bool callbackInvoked = false;
+  Data signedData, infoData;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [&](const auto& d1, const auto& d2) {
+                             callbackInvoked = true;
+                             signedData = d1;
+                             infoData = d2;
+                           },
+                           [](const auto& reason) {
+                             BOOST_CHECK(false);
+                           });
+  advanceClocks(time::milliseconds(100), 20);
+  BOOST_CHECK(callbackInvoked);
+  BOOST_CHECK(verifier.verify(signedData, infoData));
+
+  // the unsigned Data is encrypted once and the same packet is served to every signer,
+  // while the per-signer parameter Data only carry a wrapped content key
+  std::set<std::vector<uint8_t>> groupPackets;
+  size_t nGroupData = 0;
+  size_t nKeyData = 0;
+  for (const auto& data : initiatorFace.sentData) {
+    if (!Name("/initiator/mps/param").isPrefixOf(data.getName())) {
+      continue;
+    }
+    if (data.getContent().value_size() > content.size()) {
+      nGroupData++;
+      const auto& wire = data.wireEncode();
+      groupPackets.emplace(wire.begin(), wire.end());
+    }
+    else {
+      nKeyData++;
+      BOOST_CHECK_LT(data.getContent().value_size(), 256);
+    }
+  }
+  BOOST_CHECK_EQUAL(nGroupData, 3);
+  BOOST_CHECK_EQUAL(groupPackets.size(), 1);
+  BOOST_CHECK_EQUAL(nKeyData, 3);
+}
+
+BOOST_AUTO_TEST_CASE(GroupParameterServedUntilFinished)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  SignerLimits limits;
+  limits.requestLifetime = time::seconds(60);
+  signer.setLimits(limits);
+  // hold the request past the lifetime of the per-signer parameter handlers
+  std::vector<PolicyDecisionCallback> pendingDecisions;
+  signer.setAsyncVerifyToBeSignedCallback([&] (const Data&, const PolicyDecisionCallback& done) {
+    pendingDecisions.push_back(done);
+  });
+  signer.setPolicyTimeout(time::seconds(60));
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.setGroupParameterMode(true);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+  bool callbackInvoked = false;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [&](const auto&, const auto&) { callbackInvoked = true; },
+                           [](const auto&) { BOOST_CHECK(false); });
+  advanceClocks(time::milliseconds(10), 10);
+  auto groupInterest = std::find_if(face.sentInterests.begin(), face.sentInterests.end(), [](const Interest& interest) {
+    return Name("/initiator/mps").isPrefixOf(interest.getName()) && interest.getName().get(-1).isImplicitSha256Digest();
+  });
+  BOOST_REQUIRE(groupInterest != face.sentInterests.end());
+  Interest lateInterest(*groupInterest);
+
+  auto isGroupParameterServed = [&] {
+    face.sentData.clear();
+    lateInterest.refreshNonce();
+    face.receive(lateInterest);
+    advanceClocks(time::milliseconds(10), 1);
+    return std::any_of(face.sentData.begin(), face.sentData.end(), [&](const Data& data) {
+      return data.getFullName() == lateInterest.getName();
+    });
+  };
+  advanceClocks(time::milliseconds(100), 150);
+  BOOST_CHECK(!callbackInvoked);
+  BOOST_CHECK(isGroupParameterServed());
+
+  for (const auto& decide : pendingDecisions) {
+    decide(true);
+  }
+  advanceClocks(time::milliseconds(100), 30);
+  BOOST_CHECK(callbackInvoked);
+  BOOST_CHECK(!isGroupParameterServed());
+}
+
+BOOST_AUTO_TEST_CASE(HedgedSigners)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  std::vector<std::unique_ptr<BLSSigner>> signers;
+  for (size_t i = 0; i < 4; i++) {
+    std::string prefix = "/signer" + std::to_string(i + 1);
+    signers.emplace_back(std::make_unique<BLSSigner>(Name(prefix), face, m_keyChain, Name(prefix + "/KEY/123")));
+  }
+  // signer1 never decides within the session
+  std::vector<PolicyDecisionCallback> pendingDecisions;
+  signers[0]->setAsyncVerifySignRequestCallback([&] (const Interest&, const PolicyDecisionCallback& done) {
+    pendingDecisions.push_back(done);
+  });
+  signers[0]->setPolicyTimeout(time::seconds(10));
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.setMaxHedgedSigners(1);
+  BLSVerifier verifier(face);
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_minOptionalSigners = 2;
+  for (size_t i = 0; i < 4; i++) {
+    schema.m_optionalSigners.emplace_back(signers[i]->getPublicKeyName());
+    initiator.m_schemaContainer.m_trustedIds.emplace(signers[i]->getPublicKeyName(), signers[i]->getPublicKey());
+    verifier.m_schemaContainer.m_trustedIds.emplace(signers[i]->getPublicKeyName(), signers[i]->getPublicKey());
+  }
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+  bool callbackInvoked = false;
+  Data signedData, infoData;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [&](const auto& d1, const auto& d2) {
+                             callbackInvoked = true;
+                             signedData = d1;
+                             infoData = d2;
+                           },
+                           [](const auto& reason) {
+                             BOOST_CHECK(false);
+                           });
+  // finished by signer2 and the hedged signer3, without waiting for signer1 to time out
+  advanceClocks(time::milliseconds(100), 10);
+  BOOST_CHECK(callbackInvoked);
+  BOOST_CHECK_EQUAL(pendingDecisions.size(), 1);
+  BOOST_CHECK(verifier.verify(signedData, infoData));
+  const auto& signerListBlock = infoData.getContent();
+  signerListBlock.parse();
+  MpsSignerList signerList;
+  signerList.wireDecode(signerListBlock.get(tlv::MpsSignerList));
+  BOOST_CHECK(signerList.m_signers == std::vector<Name>({Name("/signer2/KEY/123"), Name("/signer3/KEY/123")}));
+
+  // at most one extra request is sent, signer4 is never asked
+  for (const auto& interest : face.sentInterests) {
+    BOOST_CHECK(!Name("/signer4/mps/sign").isPrefixOf(interest.getName()));
+  }
+  // the request to signer1 is cancelled: its late share is neither fetched nor reported
+  pendingDecisions[0](true);
+  face.sentInterests.clear();
+  advanceClocks(time::milliseconds(100), 30);
+  for (const auto& interest : face.sentInterests) {
+    BOOST_CHECK(!Name("/signer1").isPrefixOf(interest.getName()));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ResultFetchSlotsReleased)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  signer.setLongPollHold(time::seconds(2));
+  SignerLimits limits;
+  limits.requestLifetime = time::seconds(60);
+  signer.setLimits(limits);
+  // the result Interests are held by the signer until the test accepts the requests
+  bool isAccepting = false;
+  std::vector<PolicyDecisionCallback> pendingDecisions;
+  signer.setAsyncVerifyToBeSignedCallback([&] (const Data&, const PolicyDecisionCallback& done) {
+    if (isAccepting) {
+      done(true);
+    }
+    else {
+      pendingDecisions.push_back(done);
+    }
+  });
+  signer.setPolicyTimeout(time::seconds(60));
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  ResultPollerOptions options;
+  options.maxOutstanding = 2;
+  initiator.getResultPoller().setOptions(options);
+  initiator.setSessionDeadline(time::milliseconds(500));
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  // each session expires with its result Interest in flight
+  int nFailures = 0;
+  for (int i = 0; i < 4; i++) {
+    Data unsignedData;
+    unsignedData.setName(Name("/a/b").appendNumber(i));
+    unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+    initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                             [](const auto&, const auto&) { BOOST_CHECK(false); },
+                             [&](const auto&) { nFailures++; });
+    advanceClocks(time::milliseconds(100), 10);
+  }
+  BOOST_CHECK_EQUAL(nFailures, 4);
+  BOOST_CHECK_EQUAL(pendingDecisions.size(), 4);
+  BOOST_CHECK_EQUAL(initiator.getResultPoller().getNOutstanding(), 0);
+  BOOST_CHECK_EQUAL(initiator.getResultPoller().getNQueued(), 0);
+
+  // the result fetches of new sessions still go out
+  isAccepting = true;
+  initiator.setSessionDeadline(time::seconds(5));
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+  bool callbackInvoked = false;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [&](const auto&, const auto&) { callbackInvoked = true; },
+                           [](const auto&) { BOOST_CHECK(false); });
+  advanceClocks(time::milliseconds(10), 30);
+  BOOST_CHECK(callbackInvoked);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidShareReplaced)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  std::vector<std::unique_ptr<BLSSigner>> signers;
+  for (size_t i = 0; i < 3; i++) {
+    std::string prefix = "/signer" + std::to_string(i + 1);
+    signers.emplace_back(std::make_unique<BLSSigner>(Name(prefix), face, m_keyChain, Name(prefix + "/KEY/123")));
+  }
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  BLSVerifier verifier(face);
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_minOptionalSigners = 2;
+  for (size_t i = 0; i < 3; i++) {
+    schema.m_optionalSigners.emplace_back(signers[i]->getPublicKeyName());
+    verifier.m_schemaContainer.m_trustedIds.emplace(signers[i]->getPublicKeyName(), signers[i]->getPublicKey());
+  }
+  // the initiator's key of signer1 does not match the shares signer1 produces
+  BLSSecretKey otherSk;
+  BLSPublicKey otherPk;
+  blsSecretKeySetByCSPRNG(&otherSk);
+  blsGetPublicKey(&otherPk, &otherSk);
+  initiator.m_schemaContainer.m_trustedIds.emplace(signers[0]->getPublicKeyName(), otherPk);
+  initiator.m_schemaContainer.m_trustedIds.emplace(signers[1]->getPublicKeyName(), signers[1]->getPublicKey());
+  initiator.m_schemaContainer.m_trustedIds.emplace(signers[2]->getPublicKeyName(), signers[2]->getPublicKey());
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+  bool callbackInvoked = false;
+  Data signedData, infoData;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [&](const auto& d1, const auto& d2) {
+                             callbackInvoked = true;
+                             signedData = d1;
+                             infoData = d2;
+                           },
+                           [](const auto& reason) {
+                             BOOST_CHECK(false);
+                           });
+  advanceClocks(time::milliseconds(100), 20);
+  BOOST_CHECK(callbackInvoked);
+  BOOST_CHECK(verifier.verify(signedData, infoData));
+  const auto& signerListBlock = infoData.getContent();
+  signerListBlock.parse();
+  MpsSignerList signerList;
+  signerList.wireDecode(signerListBlock.get(tlv::MpsSignerList));
+  BOOST_CHECK(signerList.m_signers == std::vector<Name>({Name("/signer2/KEY/123"), Name("/signer3/KEY/123")}));
+  BOOST_CHECK_EQUAL(initiator.m_schemaContainer.m_unavailableSigners.count(Name("/signer1/KEY/123")), 1);
+}
+
+BOOST_AUTO_TEST_CASE(BatchSigning)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  std::vector<std::unique_ptr<BLSSigner>> signers;
+  for (size_t i = 0; i < 2; i++) {
+    std::string prefix = "/signer" + std::to_string(i + 1);
+    signers.emplace_back(std::make_unique<BLSSigner>(Name(prefix), face, m_keyChain, Name(prefix + "/KEY/123")));
+  }
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  BLSVerifier verifier(face);
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_minOptionalSigners = 0;
+  for (size_t i = 0; i < 2; i++) {
+    schema.m_signers.emplace_back(signers[i]->getPublicKeyName());
+    initiator.m_schemaContainer.m_trustedIds.emplace(signers[i]->getPublicKeyName(), signers[i]->getPublicKey());
+    verifier.m_schemaContainer.m_trustedIds.emplace(signers[i]->getPublicKeyName(), signers[i]->getPublicKey());
+  }
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  std::vector<Data> batch;
+  for (size_t i = 0; i < 10; i++) {
+    Data unsignedData;
+    unsignedData.setName(Name("/a/b").appendNumber(i));
+    unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+    batch.push_back(unsignedData);
+  }
+  bool callbackInvoked = false;
+  std::vector<Data> signedData;
+  Data infoData;
+  initiator.multiPartySignBatch(batch, schema, initiatorId.getDefaultKey().getName(),
+                                [&](const auto& data, const auto& info) {
+                                  callbackInvoked = true;
+                                  signedData = data;
+                                  infoData = info;
+                                },
+                                [](const auto& reason) {
+                                  BOOST_CHECK(false);
+                                });
+  advanceClocks(time::milliseconds(100), 20);
+  BOOST_REQUIRE(callbackInvoked);
+  BOOST_REQUIRE_EQUAL(signedData.size(), batch.size());
+  for (size_t i = 0; i < batch.size(); i++) {
+    BOOST_CHECK_EQUAL(signedData[i].getName(), batch[i].getName());
+    BOOST_CHECK_EQUAL(signedData[i].getKeyLocator()->getName(), infoData.getName());
+    BOOST_CHECK(verifier.verify(signedData[i], infoData));
+  }
+  // one sign request per signer for the whole batch
+  size_t nSignRequests = 0;
+  for (const auto& interest : face.sentInterests) {
+    if (interest.getName().size() > 2 && interest.getName().get(1) == name::Component("mps") &&
+        interest.getName().get(2) == name::Component("sign")) {
+      nSignRequests++;
+    }
+  }
+  BOOST_CHECK_EQUAL(nSignRequests, 2);
+
+  // a batch that does not fit in a result is refused
+  bool failureInvoked = false;
+  initiator.multiPartySignBatch(std::vector<Data>(65, batch.front()), schema, initiatorId.getDefaultKey().getName(),
+                                [](const auto&, const auto&) { BOOST_CHECK(false); },
+                                [&](const auto&) { failureInvoked = true; });
+  BOOST_CHECK(failureInvoked);
+}
+
+BOOST_AUTO_TEST_CASE(HandshakeCoalescing)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  signer.setSessionLifetime(time::seconds(60));
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  // start two concurrent sessions, return the number of full handshakes and resumed sign requests
+  size_t nextPacket = 0;
+  auto signConcurrently = [&] {
+    face.sentInterests.clear();
+    size_t nFinished = 0;
+    for (size_t i = 0; i < 2; i++) {
+      Data unsignedData;
+      unsignedData.setName(Name("/a/b").appendNumber(nextPacket++));
+      unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+      initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                               [&](const auto&, const auto&) { nFinished++; },
+                               [](const auto& reason) { BOOST_CHECK(false); });
+    }
+    advanceClocks(time::milliseconds(100), 20);
+    BOOST_CHECK_EQUAL(nFinished, 2);
+    size_t nHandshakes = 0;
+    size_t nResumed = 0;
+    for (const auto& interest : face.sentInterests) {
+      if (!Name("/signer/mps/sign").isPrefixOf(interest.getName())) {
+        continue;
+      }
+      const auto& params = interest.getApplicationParameters();
+      params.parse();
+      if (params.find(tlv::EcdhPub) != params.elements_end()) {
+        nHandshakes++;
+      }
+      else if (params.find(tlv::SessionId) != params.elements_end()) {
+        nResumed++;
+      }
+    }
+    return std::make_pair(nHandshakes, nResumed);
+  };
+
+  // without session resumption, each session runs its own handshake
+  BOOST_CHECK(signConcurrently() == std::make_pair<size_t, size_t>(2, 0));
+
+  // with it, the second session waits for the handshake of the first and resumes its session
+  initiator.setSessionLifetime(time::seconds(60));
+  BOOST_CHECK(signConcurrently() == std::make_pair<size_t, size_t>(1, 1));
+}
+
+BOOST_AUTO_TEST_CASE(SingleInitiatorRoute)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto countRegistrations = [&] {
+    size_t nRegistrations = 0;
+    for (const auto& interest : face.sentInterests) {
+      if (Name("/localhost/nfd/rib/register").isPrefixOf(interest.getName())) {
+        nRegistrations++;
+      }
+    }
+    return nRegistrations;
+  };
+  auto nRegistrations = countRegistrations();
+
+  std::vector<Data> infoPackets;
+  for (size_t i = 0; i < 3; i++) {
+    Data unsignedData;
+    unsignedData.setName(Name("/a/b").appendNumber(i));
+    unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+    initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                             [&](const auto&, const auto& infoData) { infoPackets.push_back(infoData); },
+                             [](const auto& reason) { BOOST_CHECK(false); });
+    advanceClocks(time::milliseconds(100), 20);
+  }
+  BOOST_REQUIRE_EQUAL(infoPackets.size(), 3);
+  // the parameter Data of every session are served without new registrations
+  BOOST_CHECK_EQUAL(countRegistrations(), nRegistrations);
+
+  // the signature info Data is served from the same route until it expires
+  face.sentData.clear();
+  face.receive(Interest(infoPackets[1].getName()));
+  advanceClocks(time::milliseconds(10), 1);
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  BOOST_CHECK(face.sentData[0].wireEncode() == infoPackets[1].wireEncode());
+  advanceClocks(time::seconds(10), 7);
+  face.sentData.clear();
+  face.receive(Interest(infoPackets[1].getName()));
+  advanceClocks(time::milliseconds(10), 1);
+  BOOST_CHECK_EQUAL(face.sentData.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(SessionDeadlineAndTable)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  std::vector<PolicyDecisionCallback> pendingDecisions;
+  signer.setAsyncVerifyToBeSignedCallback([&] (const Data&, const PolicyDecisionCallback& done) {
+    pendingDecisions.push_back(done);
+  });
+  signer.setPolicyTimeout(time::seconds(60));
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  initiator.setSessionDeadline(time::seconds(2));
+  initiator.setMaxSessions(2);
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  std::vector<std::string> failures;
+  for (size_t i = 0; i < 3; i++) {
+    Data unsignedData;
+    unsignedData.setName(Name("/a/b").appendNumber(i));
+    unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+    initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                             [](const auto&, const auto&) { BOOST_CHECK(false); },
+                             [&](const auto& reason) { failures.push_back(reason); });
+  }
+  // the third session is refused right away, the table holds the first two
+  BOOST_REQUIRE_EQUAL(failures.size(), 1);
+  BOOST_CHECK_EQUAL(initiator.getSessionCounters().nRejectedSessions, 1);
+  BOOST_CHECK_EQUAL(initiator.getSessionCounters().nLiveSessions, 2);
+  BOOST_CHECK_GT(initiator.getSessionCounters().nLiveSessionBytes, 0);
+  advanceClocks(time::milliseconds(100), 10);
+  BOOST_CHECK_EQUAL(pendingDecisions.size(), 2);
+  BOOST_CHECK_EQUAL(failures.size(), 1);
+
+  // the signer never decides, so both sessions fail at their deadline
+  advanceClocks(time::milliseconds(100), 15);
+  BOOST_CHECK_EQUAL(failures.size(), 3);
+  BOOST_CHECK_EQUAL(initiator.getSessionCounters().nExpiredSessions, 2);
+  BOOST_CHECK_EQUAL(initiator.getSessionCounters().nLiveSessions, 0);
+  BOOST_CHECK_EQUAL(initiator.getSessionCounters().nLiveSessionBytes, 0);
+
+  // nothing is fetched for the expired sessions afterwards
+  face.sentInterests.clear();
+  advanceClocks(time::milliseconds(200), 40);
+  for (const auto& interest : face.sentInterests) {
+    BOOST_CHECK(!Name("/signer").isPrefixOf(interest.getName()));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(AggregationTree)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  // two sub-aggregators with two signers each
+  std::vector<std::unique_ptr<BLSSigner>> leaves;
+  std::vector<std::unique_ptr<SubAggregator>> subAggregators;
+  std::vector<BLSPublicKey> leafKeys;
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  // the session schema names the sub-aggregators, the schema of the verifiers names the leaves
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_minOptionalSigners = 0;
+  MultipartySchema verifierSchema = schema;
+  BLSVerifier verifier(face);
+  for (size_t i = 0; i < 2; i++) {
+    MultipartySchema subtreeSchema;
+    subtreeSchema.m_pktName = WildCardName("/a/b/*");
+    subtreeSchema.m_ruleId = "01";
+    subtreeSchema.m_minOptionalSigners = 0;
+    std::map<Name, BLSPublicKey> subtreeKeys;
+    for (size_t j = 0; j < 2; j++) {
+      std::string prefix = "/leaf" + std::to_string(i * 2 + j + 1);
+      leaves.emplace_back(std::make_unique<BLSSigner>(Name(prefix), face, m_keyChain, Name(prefix + "/KEY/123")));
+      subtreeSchema.m_signers.emplace_back(leaves.back()->getPublicKeyName());
+      subtreeKeys.emplace(leaves.back()->getPublicKeyName(), leaves.back()->getPublicKey());
+      verifierSchema.m_signers.emplace_back(leaves.back()->getPublicKeyName());
+      leafKeys.push_back(leaves.back()->getPublicKey());
+    }
+    std::string prefix = "/agg" + std::to_string(i + 1);
+    auto aggregatorId = addIdentity(prefix);
+    subAggregators.emplace_back(std::make_unique<SubAggregator>(Name(prefix), face, m_keyChain, scheduler,
+                                                                Name(prefix + "/KEY/123"),
+                                                                aggregatorId.getDefaultKey().getName(),
+                                                                subtreeSchema));
+    subAggregators.back()->getInitiator().m_schemaContainer.m_trustedIds = subtreeKeys;
+    // the root addresses the sub-aggregator and checks its partial aggregates with the keys of the leaves
+    schema.m_signers.emplace_back(Name(prefix + "/KEY/123"));
+    initiator.m_schemaContainer.m_trustedIds.emplace(Name(prefix + "/KEY/123"),
+                                                     subAggregators.back()->getSigner().getPublicKey());
+    initiator.m_schemaContainer.m_trustedIds.insert(subtreeKeys.begin(), subtreeKeys.end());
+    verifier.m_schemaContainer.m_trustedIds.insert(subtreeKeys.begin(), subtreeKeys.end());
+  }
+  initiator.m_schemaContainer.m_schemas.push_back(verifierSchema);
+  verifier.m_schemaContainer.m_schemas.push_back(verifierSchema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+  bool callbackInvoked = false;
+  Data signedData;
+  Data infoData;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [&](const auto& data, const auto& info) {
+                             callbackInvoked = true;
+                             signedData = data;
+                             infoData = info;
+                           },
+                           [](const auto& reason) { BOOST_CHECK(false); });
+  advanceClocks(time::milliseconds(100), 60);
+  BOOST_REQUIRE(callbackInvoked);
+
+  // the signer list names the leaves, whose aggregate key verifies the signature
+  MpsSignerList signerList(infoData.getContent().blockFromValue());
+  BOOST_CHECK_EQUAL(signerList.m_signers.size(), 4);
+  for (const auto& leaf : leaves) {
+    BOOST_CHECK(std::find(signerList.m_signers.begin(), signerList.m_signers.end(),
+                          leaf->getPublicKeyName()) != signerList.m_signers.end());
+  }
+  BOOST_CHECK(ndnBLSVerify(leafKeys, signedData));
+  BOOST_CHECK(verifier.verify(signedData, infoData));
+
+  // the root sends one sign request per sub-aggregator
+  size_t nRootSignRequests = 0;
+  for (const auto& interest : face.sentInterests) {
+    if (Name("/agg1/mps/sign").isPrefixOf(interest.getName()) ||
+        Name("/agg2/mps/sign").isPrefixOf(interest.getName())) {
+      nRootSignRequests++;
+    }
+  }
+  BOOST_CHECK_EQUAL(nRootSignRequests, 2);
+}
+
+BOOST_AUTO_TEST_CASE(AggregationTreeUntrustedLeaf)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.setShareVerification(false);
+  std::vector<std::unique_ptr<BLSSigner>> leaves;
+  MultipartySchema subtreeSchema;
+  subtreeSchema.m_pktName = WildCardName("/a/b/*");
+  subtreeSchema.m_ruleId = "01";
+  subtreeSchema.m_minOptionalSigners = 0;
+  std::map<Name, BLSPublicKey> subtreeKeys;
+  for (size_t i = 0; i < 2; i++) {
+    std::string prefix = "/leaf" + std::to_string(i + 1);
+    leaves.emplace_back(std::make_unique<BLSSigner>(Name(prefix), face, m_keyChain, Name(prefix + "/KEY/123")));
+    subtreeSchema.m_signers.emplace_back(leaves.back()->getPublicKeyName());
+    subtreeKeys.emplace(leaves.back()->getPublicKeyName(), leaves.back()->getPublicKey());
+  }
+  auto aggregatorId = addIdentity("/agg1");
+  SubAggregator subAggregator(Name("/agg1"), face, m_keyChain, scheduler, Name("/agg1/KEY/123"),
+                              aggregatorId.getDefaultKey().getName(), subtreeSchema);
+  subAggregator.getInitiator().m_schemaContainer.m_trustedIds = subtreeKeys;
+
+  // the root does not know the key of /leaf2, so it cannot check the partial aggregate
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_minOptionalSigners = 0;
+  schema.m_signers.emplace_back(Name("/agg1/KEY/123"));
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/agg1/KEY/123"), subAggregator.getSigner().getPublicKey());
+  initiator.m_schemaContainer.m_trustedIds.emplace(leaves[0]->getPublicKeyName(), leaves[0]->getPublicKey());
+  MultipartySchema verifierSchema = subtreeSchema;
+  initiator.m_schemaContainer.m_schemas.push_back(verifierSchema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+  bool failureInvoked = false;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [](const auto&, const auto&) { BOOST_CHECK(false); },
+                           [&](const auto&) { failureInvoked = true; });
+  advanceClocks(time::milliseconds(100), 60);
+  BOOST_CHECK(failureInvoked);
+}
+
+BOOST_AUTO_TEST_CASE(AsyncVerifyCoalescing)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  BLSVerifier verifier(face);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  verifier.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  std::vector<Data> batch;
+  for (size_t i = 0; i < 3; i++) {
+    Data unsignedData;
+    unsignedData.setName(Name("/a/b").appendNumber(i));
+    unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+    batch.push_back(unsignedData);
+  }
+  std::vector<Data> signedData;
+  initiator.multiPartySignBatch(batch, schema, initiatorId.getDefaultKey().getName(),
+                                [&](const auto& data, const auto&) { signedData = data; },
+                                [](const auto&) { BOOST_CHECK(false); });
+  advanceClocks(time::milliseconds(100), 20);
+  BOOST_REQUIRE_EQUAL(signedData.size(), 3);
+
+  auto infoName = signedData.front().getKeyLocator()->getName();
+  auto countInfoFetches = [&] {
+    size_t nFetches = 0;
+    for (const auto& interest : face.sentInterests) {
+      if (interest.getName() == infoName) {
+        nFetches++;
+      }
+    }
+    return nFetches;
+  };
+  // the packets share one signature info Data, which is fetched once for all of them
+  size_t nValid = 0;
+  for (const auto& data : signedData) {
+    verifier.asyncVerify(data, [&](bool isValid) { nValid += isValid; });
+  }
+  BOOST_CHECK_EQUAL(verifier.getNPendingFetches(), 1);
+  advanceClocks(time::milliseconds(10), 10);
+  BOOST_CHECK_EQUAL(nValid, 3);
+  BOOST_CHECK_EQUAL(countInfoFetches(), 1);
+  BOOST_CHECK_EQUAL(verifier.getNPendingFetches(), 0);
+
+  // later packets are verified with the cached signer list
+  verifier.asyncVerify(signedData.front(), [&](bool isValid) { nValid += isValid; });
+  BOOST_CHECK_EQUAL(nValid, 4);
+  BOOST_CHECK_EQUAL(countInfoFetches(), 1);
+  BOOST_CHECK_EQUAL(verifier.getSignerInfoCache().getNHits(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(BatchVerificationQueue)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  BLSVerifier verifier(face);
+  verifier.setBatchVerification(4, time::milliseconds(50));
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  verifier.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_schemas.push_back(schema);
+  advanceClocks(time::milliseconds(20), 10);
+
+  std::vector<Data> batch;
+  for (size_t i = 0; i < 6; i++) {
+    Data unsignedData;
+    unsignedData.setName(Name("/a/b").appendNumber(i));
+    unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+    batch.push_back(unsignedData);
+  }
+  std::vector<Data> signedData;
+  initiator.multiPartySignBatch(batch, schema, initiatorId.getDefaultKey().getName(),
+                                [&](const auto& data, const auto&) { signedData = data; },
+                                [](const auto&) { BOOST_CHECK(false); });
+  advanceClocks(time::milliseconds(100), 20);
+  BOOST_REQUIRE_EQUAL(signedData.size(), 6);
+  // packet 3 carries the signature of packet 2
+  signedData[3].setSignatureValue(std::make_shared<Buffer>(signedData[2].getSignatureValue().value(),
+                                                           signedData[2].getSignatureValue().value_size()));
+
+  std::map<size_t, bool> results;
+  for (size_t i = 0; i < signedData.size(); i++) {
+    verifier.asyncVerify(signedData[i], [&results, i](bool isValid) { results[i] = isValid; });
+  }
+  // the first four packets fill a batch once the signer list arrives, the other two wait for the window
+  advanceClocks(time::milliseconds(10), 3);
+  BOOST_CHECK_EQUAL(results.size(), 4);
+  BOOST_CHECK_EQUAL(verifier.getNQueuedVerifications(), 2);
+  advanceClocks(time::milliseconds(10), 10);
+  BOOST_REQUIRE_EQUAL(results.size(), 6);
+  BOOST_CHECK_EQUAL(verifier.getNVerifiedBatches(), 2);
+  for (size_t i = 0; i < signedData.size(); i++) {
+    BOOST_CHECK_EQUAL(results[i], i != 3);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(VerifierEngineOffload)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  advanceClocks(time::milliseconds(20), 10);
+
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  BLSVerifier verifier(face);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  verifier.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  schema.m_minOptionalSigners = 0;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_schemas.push_back(schema);
+  VerifierEngine engine(io, 2);
+  verifier.setVerifierEngine(&engine);
+  BOOST_CHECK_EQUAL(engine.getNThreads(), 2);
+  advanceClocks(time::milliseconds(20), 10);
+
+  std::vector<Data> batch;
+  for (size_t i = 0; i < 6; i++) {
+    Data unsignedData;
+    unsignedData.setName(Name("/a/b").appendNumber(i));
+    unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+    batch.push_back(unsignedData);
+  }
+  std::vector<Data> signedData;
+  initiator.multiPartySignBatch(batch, schema, initiatorId.getDefaultKey().getName(),
+                                [&](const auto& data, const auto&) { signedData = data; },
+                                [](const auto&) { BOOST_CHECK(false); });
+  advanceClocks(time::milliseconds(100), 20);
+  BOOST_REQUIRE_EQUAL(signedData.size(), 6);
+  signedData[3].setSignatureValue(std::make_shared<Buffer>(signedData[2].getSignatureValue().value(),
+                                                           signedData[2].getSignatureValue().value_size()));
+  signedData[3].wireEncode();
+
+  auto ioThreadId = std::this_thread::get_id();
+  std::map<size_t, bool> results;
+  for (size_t i = 0; i < signedData.size(); i++) {
+    verifier.asyncVerify(signedData[i], [&results, &ioThreadId, i](bool isValid) {
+      BOOST_CHECK(std::this_thread::get_id() == ioThreadId);
+      results[i] = isValid;
+    });
+  }
+  // the results are posted back by the workers and picked up by the I/O thread
+  for (int i = 0; i < 500 && results.size() < signedData.size(); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    advanceClocks(time::milliseconds(1), 1);
+  }
+  BOOST_REQUIRE_EQUAL(results.size(), 6);
+  for (size_t i = 0; i < signedData.size(); i++) {
+    BOOST_CHECK_EQUAL(results[i], i != 3);
+  }
+
+  // a trust change takes effect once published to the engine
+  verifier.m_schemaContainer.m_trustedIds.clear();
+  verifier.setVerifierEngine(&engine);
+  BOOST_CHECK(engine.getSchemaSnapshot()->m_trustedIds.empty());
+  bool isVerified = true;
+  verifier.asyncVerify(signedData[0], [&](bool isValid) { isVerified = isValid; });
+  for (int i = 0; i < 500 && isVerified; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    advanceClocks(time::milliseconds(1), 1);
+  }
+  BOOST_CHECK(!isVerified);
+}
+
 // BOOST_AUTO_TEST_CASE(VerifierFetch)
 // {
 //   util::DummyClientFace face(io, m_keyChain, {true, true});
@@ -0,0 +1,77 @@
+#include "ndnmps/publication-store.hpp"
+#include "test-common.hpp"
+
+namespace ndn {
+namespace mps {
+namespace tests {
+
+BOOST_FIXTURE_TEST_SUITE(TestPublicationStore, UnitTestTimeFixture)
+
+static Data
+makeData(const Name& name)
+{
+  Data data(name);
+  data.setContent(Name("/1/2/3/4").wireEncode());
+  data.setSignatureInfo(SignatureInfo(ndn::tlv::DigestSha256));
+  data.setSignatureValue(std::make_shared<Buffer>(32));
+  data.wireEncode();
+  return data;
+}
+
+BOOST_AUTO_TEST_CASE(FindByName)
+{
+  PublicationStore store;
+  store.insert(makeData("/initiator/mps/1"), time::seconds(10));
+  store.insert(makeData("/initiator/mps/2"), time::seconds(10));
+  store.insert(makeData("/a/b/c"), time::seconds(10));
+
+  const auto* data = store.find(Interest("/initiator/mps/2"));
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(data->getName(), "/initiator/mps/2");
+  BOOST_CHECK(store.find(Interest("/initiator/mps/3")) == nullptr);
+  // a prefix only matches with CanBePrefix
+  BOOST_CHECK(store.find(Interest("/a/b")) == nullptr);
+  Interest prefixInterest("/a/b");
+  prefixInterest.setCanBePrefix(true);
+  BOOST_CHECK(store.find(prefixInterest) != nullptr);
+  // the implicit digest must match
+  auto fullName = makeData("/a/b/c").getFullName();
+  BOOST_CHECK(store.find(Interest(fullName)) != nullptr);
+  BOOST_CHECK(store.find(Interest(Name("/a/b/c").appendImplicitSha256Digest(std::make_shared<Buffer>(32)))) == nullptr);
+  BOOST_CHECK_EQUAL(store.getNHits(), 3);
+  BOOST_CHECK_EQUAL(store.getNMisses(), 3);
+
+  advanceClocks(time::seconds(11));
+  BOOST_CHECK(store.find(Interest("/initiator/mps/2")) == nullptr);
+  BOOST_CHECK(store.erase("/initiator/mps/1"));
+  BOOST_CHECK(!store.erase("/initiator/mps/2"));
+}
+
+BOOST_AUTO_TEST_CASE(Eviction)
+{
+  auto size = makeData("/initiator/mps/0").wireEncode().size();
+  PublicationStore store(3, size * 10);
+  for (int i = 0; i < 3; i++) {
+    store.insert(makeData(Name("/initiator/mps").appendNumber(i)), time::seconds(10));
+  }
+  // the least recently used entry goes first
+  BOOST_CHECK(store.find(Interest(Name("/initiator/mps").appendNumber(0))) != nullptr);
+  store.insert(makeData(Name("/initiator/mps").appendNumber(3)), time::seconds(10));
+  BOOST_CHECK_EQUAL(store.size(), 3);
+  BOOST_CHECK(store.find(Interest(Name("/initiator/mps").appendNumber(0))) != nullptr);
+  BOOST_CHECK(store.find(Interest(Name("/initiator/mps").appendNumber(1))) == nullptr);
+
+  // the byte limit applies as well
+  store.setLimits(3, size * 2);
+  BOOST_CHECK_EQUAL(store.size(), 2);
+  BOOST_CHECK_LE(store.getNBytes(), size * 2);
+  store.setLimits(0, size * 2);
+  BOOST_CHECK_EQUAL(store.size(), 0);
+  BOOST_CHECK_EQUAL(store.getNBytes(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestPublicationStore
+
+}  // namespace tests
+}  // namespace mps
+}  // namespace ndn
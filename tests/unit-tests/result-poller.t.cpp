@@ -0,0 +1,69 @@
+#include "ndnmps/result-poller.hpp"
+#include "test-common.hpp"
+#include <cmath>
+
+namespace ndn {
+namespace mps {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestResultPoller)
+
+BOOST_AUTO_TEST_CASE(FirstDelayAndBackoff)
+{
+  ResultPollerOptions options;
+  options.percentile = 0.5;
+  options.historySize = 4;
+  ResultPoller poller(options);
+  Name signer("/signer/KEY/123");
+
+  // no history yet: follow the signer's hint
+  BOOST_CHECK(poller.getFirstDelay(signer, time::seconds(1)) == time::seconds(1));
+  // long-poll signers are fetched immediately
+  BOOST_CHECK(poller.getFirstDelay(signer, time::milliseconds(0)) == time::milliseconds(0));
+  BOOST_CHECK(poller.getRetryDelay(3, time::milliseconds(0)) == time::milliseconds(0));
+
+  for (int ms : {500, 40, 20, 30, 10}) {
+    poller.recordServiceTime(signer, time::milliseconds(ms));
+  }
+  // the oldest sample (500 ms) has been dropped, median of {40, 20, 30, 10}
+  BOOST_CHECK(poller.getFirstDelay(signer, time::seconds(1)) == time::milliseconds(20));
+  BOOST_CHECK(poller.getFirstDelay(Name("/other/KEY/456"), time::seconds(1)) == time::seconds(1));
+
+  for (size_t i = 0; i < 10; i++) {
+    auto delay = poller.getRetryDelay(i, time::seconds(1));
+    auto base = std::min<double>(50 * std::pow(2, i), 2000);
+    BOOST_CHECK_GE(delay.count(), static_cast<int64_t>(base * 0.8) - 1);
+    BOOST_CHECK_LE(delay.count(), static_cast<int64_t>(base * 1.2) + 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(OutstandingCap)
+{
+  ResultPollerOptions options;
+  options.maxOutstanding = 2;
+  ResultPoller poller(options);
+  int nFetched = 0;
+  for (int i = 0; i < 5; i++) {
+    poller.submit([&] { nFetched++; });
+  }
+  BOOST_CHECK_EQUAL(nFetched, 2);
+  BOOST_CHECK_EQUAL(poller.getNOutstanding(), 2);
+  BOOST_CHECK_EQUAL(poller.getNQueued(), 3);
+
+  poller.onFetchDone();
+  BOOST_CHECK_EQUAL(nFetched, 3);
+  BOOST_CHECK_EQUAL(poller.getNOutstanding(), 2);
+  poller.onFetchDone();
+  poller.onFetchDone();
+  poller.onFetchDone();
+  poller.onFetchDone();
+  BOOST_CHECK_EQUAL(nFetched, 5);
+  BOOST_CHECK_EQUAL(poller.getNOutstanding(), 0);
+  BOOST_CHECK_EQUAL(poller.getNQueued(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestResultPoller
+
+}  // namespace tests
+}  // namespace mps
+}  // namespace ndn
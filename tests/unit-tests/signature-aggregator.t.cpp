@@ -0,0 +1,103 @@
+#include "ndnmps/signature-aggregator.hpp"
+#include "test-common.hpp"
+
+namespace ndn {
+namespace mps {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestSignatureAggregator)
+
+BOOST_AUTO_TEST_CASE(AddAndRemove)
+{
+  ndnBLSInit();
+
+  Data data;
+  data.setName(Name("/a/b/c/d"));
+  data.setContent(Name("/1/2/3/4").wireEncode());
+  SignatureInfo info(static_cast<ndn::tlv::SignatureTypeValue>(tlv::SignatureSha256WithBls), Name("/mps/123"));
+  data.setSignatureInfo(info);
+
+  std::vector<Name> signers;
+  std::vector<BLSPublicKey> pks;
+  std::vector<Buffer> shares;
+  for (int i = 0; i < 4; i++) {
+    BLSSecretKey sk;
+    BLSPublicKey pk;
+    blsSecretKeySetByCSPRNG(&sk);
+    blsGetPublicKey(&pk, &sk);
+    signers.emplace_back(Name("/signer" + std::to_string(i) + "/KEY/123"));
+    pks.push_back(pk);
+    shares.push_back(ndnGenBLSSignature(sk, data));
+  }
+
+  SignatureAggregator aggregator;
+  BOOST_CHECK_THROW(aggregator.getSignature(), std::runtime_error);
+  for (int i = 0; i < 4; i++) {
+    BOOST_CHECK(aggregator.add(signers[i], shares[i]));
+  }
+  // a repeated share replaces the earlier one
+  BOOST_CHECK(aggregator.add(signers[1], shares[1]));
+  BOOST_CHECK_EQUAL(aggregator.size(), 4);
+  BOOST_CHECK(aggregator.getSignature() == ndnBLSAggregateSignature(shares));
+  data.setSignatureValue(std::make_shared<Buffer>(aggregator.getSignature()));
+  BOOST_CHECK(ndnBLSVerify(pks, data));
+
+  // subtract the share of signer2
+  aggregator.remove(signers[2]);
+  BOOST_CHECK(!aggregator.contains(signers[2]));
+  BOOST_CHECK(aggregator.getSigners() == std::vector<Name>({signers[0], signers[1], signers[3]}));
+  BOOST_CHECK(aggregator.getSignature() == ndnBLSAggregateSignature(std::vector<Buffer>({shares[0], shares[1], shares[3]})));
+
+  // a share that cannot be decoded is rejected
+  BOOST_CHECK(!aggregator.add(signers[2], Buffer(10)));
+  BOOST_CHECK_EQUAL(aggregator.size(), 3);
+
+  for (const auto& signer : signers) {
+    aggregator.remove(signer);
+  }
+  BOOST_CHECK_EQUAL(aggregator.size(), 0);
+  BOOST_CHECK(aggregator.add(signers[0], shares[0]));
+  BOOST_CHECK(aggregator.getSignature() == shares[0]);
+}
+
+BOOST_AUTO_TEST_CASE(FindInvalidShares)
+{
+  ndnBLSInit();
+
+  Data data;
+  data.setName(Name("/a/b/c/d"));
+  data.setContent(Name("/1/2/3/4").wireEncode());
+  SignatureInfo info(static_cast<ndn::tlv::SignatureTypeValue>(tlv::SignatureSha256WithBls), Name("/mps/123"));
+  data.setSignatureInfo(info);
+  Data otherData(data);
+  otherData.setContent(Name("/5/6/7/8").wireEncode());
+
+  SignatureAggregator aggregator;
+  std::map<Name, BLSPublicKey> trustedKeys;
+  for (int i = 0; i < 8; i++) {
+    BLSSecretKey sk;
+    BLSPublicKey pk;
+    blsSecretKeySetByCSPRNG(&sk);
+    blsGetPublicKey(&pk, &sk);
+    Name signer("/signer" + std::to_string(i) + "/KEY/123");
+    trustedKeys.emplace(signer, pk);
+    // signer2 and signer5 sign another packet
+    aggregator.add(signer, ndnGenBLSSignature(sk, (i == 2 || i == 5) ? otherData : data));
+  }
+  BOOST_CHECK(aggregator.findInvalidShares(trustedKeys, data) ==
+              std::vector<Name>({Name("/signer2/KEY/123"), Name("/signer5/KEY/123")}));
+  BOOST_CHECK(aggregator.findInvalidShares(trustedKeys, otherData).size() == 6);
+
+  aggregator.remove(Name("/signer2/KEY/123"));
+  aggregator.remove(Name("/signer5/KEY/123"));
+  BOOST_CHECK(aggregator.findInvalidShares(trustedKeys, data).empty());
+  // a signer without a trusted key is invalid
+  trustedKeys.erase(Name("/signer7/KEY/123"));
+  BOOST_CHECK(aggregator.findInvalidShares(trustedKeys, data) == std::vector<Name>({Name("/signer7/KEY/123")}));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestSignatureAggregator
+
+}  // namespace tests
+}  // namespace mps
+}  // namespace ndn
@@ -0,0 +1,62 @@
+#include "ndnmps/signature-cache.hpp"
+#include "test-common.hpp"
+
+namespace ndn {
+namespace mps {
+namespace tests {
+
+BOOST_FIXTURE_TEST_SUITE(TestSignatureCache, UnitTestTimeFixture)
+
+BOOST_AUTO_TEST_CASE(HitMissAndEviction)
+{
+  SignatureCache cache(2, time::seconds(10));
+  std::vector<SignedPortionDigest> digests;
+  for (int i = 0; i < 3; i++) {
+    Data data(Name("/a/b").appendNumber(i));
+    data.setSignatureInfo(SignatureInfo(static_cast<ndn::tlv::SignatureTypeValue>(tlv::SignatureSha256WithBls),
+                                        KeyLocator(Name("/initiator/mps/123"))));
+    digests.push_back(computeSignedPortionDigest(data));
+  }
+  BOOST_CHECK(digests[0] != digests[1]);
+
+  BOOST_CHECK(cache.find(Name("/signer/KEY/123"), digests[0]) == nullptr);
+  cache.insert(Name("/signer/KEY/123"), digests[0], Buffer(96));
+  cache.insert(Name("/signer/KEY/123"), digests[1], Buffer(96));
+  BOOST_CHECK(cache.find(Name("/signer/KEY/123"), digests[0]) != nullptr);
+  // a different key does not share the entry
+  BOOST_CHECK(cache.find(Name("/signer/KEY/456"), digests[0]) == nullptr);
+
+  // digests[1] is the least recently used one
+  cache.insert(Name("/signer/KEY/123"), digests[2], Buffer(96));
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+  BOOST_CHECK(cache.find(Name("/signer/KEY/123"), digests[1]) == nullptr);
+  BOOST_CHECK(cache.find(Name("/signer/KEY/123"), digests[2]) != nullptr);
+  BOOST_CHECK_EQUAL(cache.getNHits(), 2);
+  BOOST_CHECK_EQUAL(cache.getNMisses(), 3);
+
+  advanceClocks(time::seconds(11));
+  BOOST_CHECK(cache.find(Name("/signer/KEY/123"), digests[0]) == nullptr);
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(EraseKey)
+{
+  SignatureCache cache(8, time::seconds(10));
+  SignedPortionDigest digest{};
+  for (uint8_t i = 0; i < 3; i++) {
+    digest[0] = i;
+    cache.insert(Name("/signer/KEY/123"), digest, Buffer(96));
+    cache.insert(Name("/signer/KEY/456"), digest, Buffer(96));
+  }
+  BOOST_CHECK_EQUAL(cache.eraseKey(Name("/signer/KEY/123")), 3);
+  BOOST_CHECK_EQUAL(cache.size(), 3);
+  BOOST_CHECK(cache.find(Name("/signer/KEY/123"), digest) == nullptr);
+  BOOST_CHECK(cache.find(Name("/signer/KEY/456"), digest) != nullptr);
+  BOOST_CHECK_EQUAL(cache.eraseKey(Name("/signer/KEY/789")), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // TestSignatureCache
+
+}  // namespace tests
+}  // namespace mps
+}  // namespace ndn
@@ -0,0 +1,45 @@
+#include "ndnmps/signer-info-cache.hpp"
+#include "test-common.hpp"
+
+namespace ndn {
+namespace mps {
+namespace tests {
+
+BOOST_FIXTURE_TEST_SUITE(TestSignerInfoCache, UnitTestTimeFixture)
+
+BOOST_AUTO_TEST_CASE(HitMissAndFreshness)
+{
+  SignerInfoCache cache(2, time::seconds(10));
+  MpsSignerList signers(std::vector<Name>{"/signer1/KEY/123", "/signer2/KEY/123"});
+
+  BOOST_CHECK(cache.find(Name("/initiator/mps/1")) == nullptr);
+  cache.insert(Name("/initiator/mps/1"), signers, time::milliseconds(0));
+  cache.insert(Name("/initiator/mps/2"), signers, time::seconds(2));
+  const auto* cached = cache.find(Name("/initiator/mps/1"));
+  BOOST_REQUIRE(cached != nullptr);
+  BOOST_CHECK(signers == *cached);
+
+  // /initiator/mps/2 is the least recently used one
+  cache.insert(Name("/initiator/mps/3"), signers, time::seconds(60));
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+  BOOST_CHECK(cache.find(Name("/initiator/mps/2")) == nullptr);
+  BOOST_CHECK_EQUAL(cache.getNHits(), 1);
+  BOOST_CHECK_EQUAL(cache.getNMisses(), 2);
+
+  // an entry without a freshness period, or a longer one, lives for the maximum TTL
+  advanceClocks(time::seconds(11));
+  BOOST_CHECK(cache.find(Name("/initiator/mps/1")) == nullptr);
+  BOOST_CHECK(cache.find(Name("/initiator/mps/3")) == nullptr);
+
+  // a shorter freshness period is respected
+  cache.insert(Name("/initiator/mps/4"), signers, time::seconds(2));
+  advanceClocks(time::seconds(3));
+  BOOST_CHECK(cache.find(Name("/initiator/mps/4")) == nullptr);
+  BOOST_CHECK_EQUAL(cache.size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // TestSignerInfoCache
+
+}  // namespace tests
+}  // namespace mps
+}  // namespace ndn